@@ -3,6 +3,7 @@
 #define LABWC_MATCH_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * match_glob() - Pattern match using shell wildcard rules (see glob(7))
@@ -12,4 +13,38 @@
  */
 bool match_glob(const char *pattern, const char *string);
 
+enum match_type {
+	LAB_MATCH_ANY = 0, /* "*" */
+	LAB_MATCH_LITERAL, /* "foo" */
+	LAB_MATCH_PREFIX, /* "foo*" */
+	LAB_MATCH_SUFFIX, /* "*foo" */
+	LAB_MATCH_GLOB, /* anything else, passed to fnmatch() */
+};
+
+/*
+ * A glob pattern compiled for repeated matching. Most patterns used in
+ * practice are plain strings or only have a leading or trailing '*',
+ * which are matched by string comparison instead of fnmatch().
+ */
+struct match_pattern {
+	enum match_type type;
+	char *str; /* the pattern without '*', or all of it for LAB_MATCH_GLOB */
+	size_t len;
+};
+
+/**
+ * match_pattern_compile() - compile a pattern for match_pattern_test()
+ * @pattern: Compiled pattern to initialize.
+ * @glob: Pattern using shell wildcard rules, as taken by match_glob().
+ */
+void match_pattern_compile(struct match_pattern *pattern, const char *glob);
+void match_pattern_finish(struct match_pattern *pattern);
+
+/**
+ * match_pattern_test() - match a string against a compiled pattern
+ * Note: Equivalent to match_glob() with the pattern the compiled pattern
+ * was created from.
+ */
+bool match_pattern_test(const struct match_pattern *pattern, const char *string);
+
 #endif /* LABWC_MATCH_H */
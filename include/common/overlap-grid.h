@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_OVERLAP_GRID_H
+#define LABWC_OVERLAP_GRID_H
+
+#include <stdbool.h>
+#include <wlr/util/box.h>
+
+/**
+ * overlap_grid_find_best() - find the position of a region which overlaps
+ * the least with a set of rectangles
+ * @bounds: area the region has to be placed within
+ * @rects: rectangles to avoid (may extend beyond @bounds)
+ * @nr_rects: number of rectangles
+ * @width: width of the region
+ * @height: height of the region
+ * @x: returns the x coordinate of the top-left corner of the region
+ * @y: returns the y coordinate of the top-left corner of the region
+ *
+ * Candidate positions align the region with the edges of the rectangles
+ * and of @bounds. Overlap is measured as area and is counted once for
+ * every rectangle covering it. Among positions with the same overlap the
+ * top-left most candidate wins.
+ *
+ * Return: false if the region does not fit within @bounds, in which case
+ * @x and @y are left unchanged
+ */
+bool overlap_grid_find_best(const struct wlr_box *bounds,
+	const struct wlr_box *rects, int nr_rects, int width, int height,
+	int *x, int *y);
+
+#endif /* LABWC_OVERLAP_GRID_H */
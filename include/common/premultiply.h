@@ -0,0 +1,21 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_PREMULTIPLY_H
+#define LABWC_PREMULTIPLY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * premultiply_argb32() - premultiply the color channels by alpha
+ * @dst: destination pixels, must not overlap with @src
+ * @src: straight (non-premultiplied) ARGB pixels in native byte order,
+ *       as used by _NET_WM_ICON and DRM_FORMAT_ARGB8888
+ * @nr_pixels: number of pixels to convert
+ *
+ * Each color channel c becomes (c * alpha + 127) / 255, i.e. rounded to
+ * the nearest value.
+ */
+void premultiply_argb32(uint32_t *restrict dst, const uint32_t *restrict src,
+	size_t nr_pixels);
+
+#endif /* LABWC_PREMULTIPLY_H */
@@ -0,0 +1,15 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_TIME_HELPERS_H
+#define LABWC_TIME_HELPERS_H
+
+#include <stdint.h>
+
+/**
+ * time_now_nsec() - Get the current time of the monotonic clock
+ *
+ * Return: time in nanoseconds, only meaningful relative to other values
+ * returned by this function
+ */
+uint64_t time_now_nsec(void);
+
+#endif /* LABWC_TIME_HELPERS_H */
@@ -36,6 +36,12 @@ enum tearing_mode {
 	LAB_TEARING_FULLSCREEN_FORCED,
 };
 
+enum render_delay_mode {
+	LAB_RENDER_DELAY_OFF = 0,
+	LAB_RENDER_DELAY_AUTO,
+	LAB_RENDER_DELAY_FIXED,
+};
+
 enum tiling_events_mode {
 	LAB_TILING_EVENTS_NEVER = 0,
 	LAB_TILING_EVENTS_REGION = 1 << 0,
@@ -57,6 +63,13 @@ struct usable_area_override {
 	struct wl_list link; /* struct rcxml.usable_area_overrides */
 };
 
+struct render_delay_config {
+	char *output; /* NULL for all outputs */
+	enum render_delay_mode mode;
+	int max_render_time; /* milliseconds, for LAB_RENDER_DELAY_FIXED */
+	struct wl_list link; /* struct rcxml.render_delays */
+};
+
 struct workspace_config {
 	struct wl_list link; /* struct rcxml.workspace_config.workspaces */
 	char *name;
@@ -118,6 +131,9 @@ struct rcxml {
 	/* <margin top="" bottom="" left="" right="" output="" /> */
 	struct wl_list usable_area_overrides;
 
+	/* <renderDelay output="" maxRenderTime="" /> */
+	struct wl_list render_delays;
+
 	/* keyboard */
 	int repeat_rate;
 	int repeat_delay;
@@ -193,6 +209,8 @@ struct rcxml {
 			enum cycle_osd_style style;
 			enum cycle_output_filter output_filter;
 			char *thumbnail_label_format;
+			bool live;
+			float live_budget; /* milliseconds per frame */
 			struct wl_list fields;  /* struct cycle_osd_field.link */
 		} osd;
 	} window_switcher;
@@ -216,6 +234,13 @@ extern struct rcxml rc;
 void rcxml_read(const char *filename);
 void rcxml_finish(void);
 
+/*
+ * Free the parsed config files which rcxml_read() keeps around to skip
+ * parsing unchanged files on the next call, then clean up libxml2. Use on
+ * exit only, after all other documents have been freed.
+ */
+void rcxml_finish_snapshots(void);
+
 /*
  * Parse the child <action> nodes and append them to the list.
  * FIXME: move this function to somewhere else.
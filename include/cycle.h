@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <wayland-server-core.h>
 #include <wlr/util/box.h>
+#include "common/edge.h"
 #include "config/types.h"
 
 struct output;
@@ -61,6 +62,13 @@ struct cycle_state {
 	struct wlr_scene_node *preview_dummy;
 	struct lab_scene_rect *preview_outline;
 	struct cycle_filter filter;
+	/* Set when showing the overview rather than the window switcher */
+	bool overview;
+	/* Next view to check for live thumbnail updates (round-robin) */
+	struct view *live_next;
+	/* Live update budget shared by outputs rendering in the same period */
+	uint64_t live_period_end; /* nsec */
+	uint64_t live_deadline; /* nsec */
 };
 
 struct cycle_osd_output {
@@ -71,6 +79,7 @@ struct cycle_osd_output {
 	/* set by cycle_osd_impl->init() */
 	struct wl_list items; /* struct cycle_osd_item.link */
 	struct wlr_scene_tree *tree;
+	int nr_cols; /* used for moving the selection up/down in a grid */
 	/* set by cycle_osd_impl->init() and moved by cycle_osd_scroll_update() */
 	struct wlr_scene_tree *items_tree;
 
@@ -97,12 +106,35 @@ void cycle_begin(struct server *server, enum lab_cycle_dir direction,
 /* Cycle the selected view in the window switcher */
 void cycle_step(struct server *server, enum lab_cycle_dir direction);
 
+/*
+ * Begin the overview, a window switcher showing thumbnails of the windows
+ * on all workspaces in a grid which stays open until a window is picked.
+ */
+void cycle_overview_begin(struct server *server);
+
+/* Move the selection of the overview towards the given edge of the grid */
+void cycle_overview_step(struct server *server, enum lab_edge direction);
+
 /* Closes the OSD */
 void cycle_finish(struct server *server, bool switch_focus);
 
 /* Re-initialize the window switcher */
 void cycle_reinitialize(struct server *server);
 
+/*
+ * Re-render outdated thumbnails of the OSD if <osd live="yes">, starting
+ * with the selected view and spending at most the configured per-frame
+ * budget on the others. Called before an output renders a frame; outputs
+ * rendering within the same refresh period share the budget.
+ */
+void cycle_osd_update_live(struct server *server);
+
+/*
+ * Size of the window icons in the classic style OSD on @output, or 0 if
+ * it shows none. Used to decode X11 icons at the sizes which are drawn.
+ */
+int cycle_osd_classic_get_icon_size(struct output *output);
+
 /* Focus the clicked window and close OSD */
 void cycle_on_cursor_release(struct server *server, struct wlr_scene_node *node);
 
@@ -136,6 +168,11 @@ struct cycle_osd_impl {
 	 * Update the OSD to highlight server->cycle.selected_view.
 	 */
 	void (*update)(struct cycle_osd_output *osd_output);
+	/*
+	 * Optional. Refresh the content of the item of @view after the
+	 * view has committed new content.
+	 */
+	void (*refresh)(struct cycle_osd_output *osd_output, struct view *view);
 };
 
 #define SCROLLBAR_W 10
@@ -12,6 +12,7 @@
 #define XCURSOR_DEFAULT "left_ptr"
 #define XCURSOR_SIZE 24
 
+struct buf;
 struct wlr_xdg_popup;
 
 enum input_mode {
@@ -190,6 +191,8 @@ struct server {
 
 	/* front to back order */
 	struct wl_list views;
+	/* oldest first, i.e. in order of view->creation_id */
+	struct wl_list views_by_age;
 	uint64_t next_view_creation_id;
 	struct wl_list unmanaged_surfaces;
 
@@ -321,6 +324,12 @@ void xdg_popup_create(struct view *view, struct wlr_xdg_popup *wlr_popup);
 void xdg_shell_init(struct server *server);
 void xdg_shell_finish(struct server *server);
 
+/*
+ * Print the configure-to-ack latency of the slowest responding xdg-shell
+ * clients, used by IPC
+ */
+void xdg_shell_print_configure_stats(struct buf *buf);
+
 /*
  * desktop.c routines deal with a collection of views
  *
@@ -355,6 +364,13 @@ void desktop_focus_view_or_surface(struct seat *seat, struct view *view,
 	struct wlr_surface *surface, bool raise);
 
 void desktop_arrange_all_views(struct server *server);
+
+/*
+ * Like desktop_arrange_all_views(), but skips views whose output did not
+ * move, resize or change its usable area since the last arrangement.
+ * Used when outputs are added, removed or reconfigured.
+ */
+void desktop_arrange_views_for_layout_change(struct server *server);
 void desktop_focus_output(struct output *output);
 
 /**
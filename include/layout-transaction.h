@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_LAYOUT_TRANSACTION_H
+#define LABWC_LAYOUT_TRANSACTION_H
+
+#include <stdbool.h>
+
+struct output;
+struct server;
+struct view;
+
+/*
+ * A layout transaction groups the geometry changes of several views, for
+ * example when all views are re-arranged after an output layout change.
+ * Outputs which show any of these views are not repainted until every
+ * view resized within the transaction has responded to its configure or
+ * a deadline has passed, so that the new layout appears in a single frame
+ * instead of mixing old and new geometry over several frames.
+ *
+ * Transactions nest. Views resized while a transaction is waiting for
+ * clients join it, but do not extend its deadline.
+ */
+
+/**
+ * layout_transaction_begin() - start collecting views which are resized
+ * @server: server
+ */
+void layout_transaction_begin(struct server *server);
+
+/**
+ * layout_transaction_commit() - stop collecting views and wait for them
+ * @server: server
+ *
+ * Must be paired with layout_transaction_begin(). Repainting resumes
+ * right away if no view needs to respond.
+ */
+void layout_transaction_commit(struct server *server);
+
+/**
+ * layout_transaction_add_view() - let a view take part in the current
+ * transaction, if any
+ * @view: view which was sent a configure changing its size
+ */
+void layout_transaction_add_view(struct view *view);
+
+/**
+ * layout_transaction_view_ready() - mark a view as done
+ * @view: view which acked its configure, timed out or is destroyed
+ */
+void layout_transaction_view_ready(struct view *view);
+
+/**
+ * layout_transaction_is_holding() - whether repainting of an output is
+ * held back
+ * @output: output
+ *
+ * Only outputs which a view waited for is or will be on are held. Frame
+ * done events should still be sent to them, since many clients only
+ * commit their resized buffer after a frame callback.
+ */
+bool layout_transaction_is_holding(struct output *output);
+
+#endif /* LABWC_LAYOUT_TRANSACTION_H */
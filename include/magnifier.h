@@ -2,12 +2,12 @@
 #ifndef LABWC_MAGNIFIER_H
 #define LABWC_MAGNIFIER_H
 
+#include <pixman.h>
 #include <stdbool.h>
 
 struct server;
 struct output;
 struct wlr_buffer;
-struct wlr_box;
 
 enum magnify_dir {
 	MAGNIFY_INCREASE,
@@ -16,9 +16,17 @@ enum magnify_dir {
 
 void magnifier_toggle(struct server *server);
 void magnifier_set_scale(struct server *server, enum magnify_dir dir);
+
+/* Returns true if the magnifier needs to be redrawn on @output */
 bool output_wants_magnification(struct output *output);
-void magnifier_draw(struct output *output, struct wlr_buffer *output_buffer,
-	struct wlr_box *damage);
+
+/*
+ * Adds the areas covered by the magnifier in the previous and the next
+ * frame to @damage. Must be called before the scene renders the frame.
+ */
+void magnifier_add_damage(struct output *output, pixman_region32_t *damage);
+
+void magnifier_draw(struct output *output, struct wlr_buffer *output_buffer);
 bool magnifier_is_enabled(void);
 void magnifier_reset(void);
 
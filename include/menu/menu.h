@@ -11,6 +11,7 @@ struct wl_list;
 struct wlr_scene_tree;
 struct wlr_scene_node;
 struct scaled_font_buffer;
+struct theme;
 
 enum menuitem_type {
 	LAB_MENU_ITEM = 0,
@@ -113,4 +114,7 @@ void menu_close_root(struct server *server);
 /* menu_reconfigure - reload theme and content */
 void menu_reconfigure(struct server *server);
 
+/* Size of the icons of menu items */
+int menu_get_icon_size(struct theme *theme);
+
 #endif /* LABWC_MENU_H */
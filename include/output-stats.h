@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_OUTPUT_STATS_H
+#define LABWC_OUTPUT_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wayland-server-core.h>
+#include <wlr/types/wlr_scene.h>
+
+struct buf;
+struct output;
+struct server;
+struct wlr_output_state;
+
+/* Number of recent frames the statistics are based on */
+#define OUTPUT_STATS_NR_SAMPLES 256
+
+/* Ring buffer of the most recent values of one metric */
+struct output_stats_series {
+	uint32_t values[OUTPUT_STATS_NR_SAMPLES];
+	size_t count;
+	size_t next;
+};
+
+struct output_stats {
+	/* CPU time to build and commit the output state in microseconds */
+	struct output_stats_series commit;
+	/* Render time in microseconds, measured on the GPU if supported */
+	struct output_stats_series render;
+	/* Time from commit to presentation in microseconds */
+	struct output_stats_series latency;
+	/* Damaged area in permille of the output */
+	struct output_stats_series damage;
+
+	uint64_t nr_frames;
+	uint64_t nr_missed; /* presented later than one refresh period */
+	uint64_t nr_discarded; /* never presented */
+
+	/* Render timer of the previous frame, read out on the next one */
+	struct wlr_scene_timer timer;
+	bool timer_pending;
+
+	/* Last commit which rendered a frame */
+	uint32_t commit_seq;
+	uint64_t commit_time; /* nanoseconds, CLOCK_MONOTONIC */
+
+	struct wlr_scene_tree *hud_tree; /* NULL unless the HUD is shown */
+	struct wl_listener present;
+};
+
+void output_stats_init(struct output *output);
+void output_stats_finish(struct output *output);
+
+/**
+ * output_stats_get_timer() - get a timer for rendering the next frame
+ * @output: output about to be rendered
+ *
+ * Also collects the result of the timer of the previous frame, which is
+ * only read out now to avoid stalling on the GPU right after the commit.
+ *
+ * Return: NULL unless the HUD is shown or the statistics were queried
+ * within the last minute, or if the renderer does not support timers
+ */
+struct wlr_scene_timer *output_stats_get_timer(struct output *output);
+
+/**
+ * output_stats_add_frame() - record a rendered and committed frame
+ * @output: output which was rendered
+ * @state: the committed state, used for the damaged area
+ * @duration: nanoseconds spent building and committing the state
+ */
+void output_stats_add_frame(struct output *output,
+	const struct wlr_output_state *state, uint64_t duration);
+
+/* Append the statistics of all outputs to @buf (IPC output-stats) */
+void output_stats_print(struct server *server, struct buf *buf);
+
+/* Show or hide the statistics on top of each output */
+void output_stats_toggle_hud(struct server *server);
+
+#endif /* LABWC_OUTPUT_STATS_H */
@@ -4,6 +4,8 @@
 
 #include <wlr/types/wlr_output.h>
 #include "common/edge.h"
+#include "output-stats.h"
+#include "render-delay.h"
 
 #define LAB_NR_LAYERS (4)
 
@@ -22,6 +24,14 @@ struct output {
 	/* In output-relative scene coordinates */
 	struct wlr_box usable_area;
 
+	/*
+	 * Layout box and usable area when views were last arranged, and
+	 * whether they changed since, see desktop_arrange_all_views()
+	 */
+	struct wlr_box arranged_box;
+	struct wlr_box arranged_usable_area;
+	bool arrangement_changed;
+
 	struct wl_list regions;  /* struct region.link */
 
 	struct wl_listener destroy;
@@ -41,6 +51,18 @@ struct output {
 	uint64_t id_bit;
 
 	bool gamma_lut_changed;
+
+	/* Defers rendering after a frame event, see render-delay.h */
+	struct wl_event_source *render_timer;
+	bool render_pending;
+	struct render_delay render_delay;
+
+	struct output_stats stats;
+
+	/* Area last drawn over by the magnifier, in physical pixels */
+	struct wlr_box magnifier_box;
+	struct wlr_fbox magnifier_src;
+	bool magnifier_cursor_locked;
 };
 
 #undef LAB_NR_LAYERS
@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_RENDER_DELAY_H
+#define LABWC_RENDER_DELAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct output;
+
+/* Number of recent frames the automatic render time is based on */
+#define RENDER_DELAY_NR_SAMPLES 64
+
+struct render_delay {
+	/* Ring buffer of the durations of recent scene commits */
+	uint64_t samples[RENDER_DELAY_NR_SAMPLES]; /* nanoseconds */
+	size_t nr_samples;
+	size_t next_sample;
+	/* Percentile of the samples, updated as samples are added */
+	uint64_t render_time; /* nanoseconds */
+};
+
+/**
+ * render_delay_get_msec() - get the time to wait after an output frame
+ * event before rendering and committing the next frame
+ * @output: output which received the frame event
+ *
+ * The delay is chosen so that rendering finishes just before the next
+ * vblank, which lets clients that commit late in the refresh cycle still
+ * make it into the frame. It depends on the <renderDelay> configuration
+ * of the output and the renderDelay window rule of its active window.
+ *
+ * Return: delay in milliseconds, 0 to render immediately
+ */
+int render_delay_get_msec(struct output *output);
+
+/**
+ * render_delay_add_sample() - record how long rendering a frame took
+ * @output: output which was rendered
+ * @duration: nanoseconds spent building and committing the output state
+ */
+void render_delay_add_sample(struct output *output, uint64_t duration);
+
+#endif /* LABWC_RENDER_DELAY_H */
@@ -48,4 +48,33 @@ void scaled_icon_buffer_set_view(struct scaled_icon_buffer *self,
 void scaled_icon_buffer_set_icon_name(struct scaled_icon_buffer *self,
 	const char *icon_name);
 
+/**
+ * scaled_icon_buffer_get_window_icon_sizes() - get the sizes in pixels at
+ * which window icons are currently drawn
+ * @server: server
+ * @sizes: wl_array of int, filled with every combination of the titlebar,
+ *	   client-list menu and window switcher icon sizes with the scales
+ *	   of all usable outputs
+ *
+ * Used to decode only those images of a client supplied multi-size icon
+ * which are ever drawn. @sizes is empty if icons are not drawn at all.
+ */
+void scaled_icon_buffer_get_window_icon_sizes(struct server *server,
+	struct wl_array *sizes);
+
+/**
+ * scaled_icon_buffer_choose_client_icon() - choose the image of a client
+ * supplied icon that is used to draw it at a given size
+ * @widths: widths of the images
+ * @nr_widths: number of images
+ * @size: size in pixels
+ *
+ * The smallest image not smaller than @size is preferred, otherwise the
+ * largest image is used.
+ *
+ * Return: index into @widths, or -1 if @nr_widths is 0
+ */
+int scaled_icon_buffer_choose_client_icon(const int *widths, int nr_widths,
+	int size);
+
 #endif /* LABWC_SCALED_ICON_BUFFER_H */
@@ -25,6 +25,7 @@ struct wlr_cursor;
 struct server;
 struct ssd;
 struct ssd_button;
+struct theme;
 struct view;
 struct wlr_scene;
 struct wlr_scene_node;
@@ -66,6 +67,9 @@ enum lab_node_type ssd_get_resizing_type(const struct ssd *ssd,
 	struct wlr_cursor *cursor);
 enum lab_ssd_mode ssd_mode_parse(const char *mode);
 
+/* Returns the area of the window icon within its titlebar button */
+struct wlr_box ssd_get_window_icon_box(struct theme *theme);
+
 /* TODO: clean up / update */
 struct border ssd_thickness(struct view *view);
 struct wlr_box ssd_max_extents(struct view *view);
@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_STARTUP_PROFILE_H
+#define LABWC_STARTUP_PROFILE_H
+
+/*
+ * The startup profiler records how long each phase of the compositor
+ * startup takes, from main() until the first frame has been rendered on
+ * any output. It is enabled with --profile-startup <file> or by setting
+ * LABWC_STARTUP_PROFILE=<file>, and is a no-op otherwise.
+ *
+ * When the first frame is rendered a summary sorted by duration is
+ * printed to stderr and all phases are written to <file> in the Trace
+ * Event Format, which can be loaded into chrome://tracing or Perfetto.
+ */
+
+/**
+ * startup_profile_init() - enable the profiler
+ * @trace_path: file to write the trace to, or NULL to leave it disabled
+ *
+ * Timestamps are relative to the time of this call, so call it as early
+ * as possible.
+ */
+void startup_profile_init(const char *trace_path);
+
+/**
+ * startup_profile_begin() - start a phase
+ * @name: name of the phase, which must be a string literal
+ *
+ * Phases nest: a phase started before the previous one has ended is
+ * recorded as a child of it.
+ */
+void startup_profile_begin(const char *name);
+
+/**
+ * startup_profile_end() - end the most recently started phase
+ */
+void startup_profile_end(void);
+
+/**
+ * startup_profile_report() - end all phases, then print the summary and
+ * write the trace file
+ *
+ * Only the first call does anything. It is made once the first frame has
+ * been rendered, and again on exit in case no frame ever was.
+ */
+void startup_profile_report(void);
+
+#endif /* LABWC_STARTUP_PROFILE_H */
@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_THUMBNAIL_H
+#define LABWC_THUMBNAIL_H
+
+#include <stdbool.h>
+
+struct output;
+struct server;
+struct view;
+struct wlr_buffer;
+
+/**
+ * thumbnail_get() - get a downscaled snapshot of the content of a view
+ * @output: output whose scale and buffer format are used for rendering
+ * @view: view to capture
+ * @max_width: maximum width of the thumbnail in logical pixels
+ * @max_height: maximum height of the thumbnail in logical pixels
+ *
+ * The snapshot is rendered at thumbnail resolution (preserving the aspect
+ * ratio of the view) in physical pixels of @output, with the content
+ * downscaled on the GPU using bilinear filtering. A few sizes are cached
+ * per view, so that switching between the window switcher and the
+ * overview or between outputs with different scales does not re-render
+ * them. A cached buffer is returned as long as no surface of the view has
+ * committed since it was captured. Otherwise a new thumbnail is rendered
+ * into a second buffer, so buffers returned before are never modified.
+ *
+ * Return: a buffer owned by the cache, or NULL on failure. Callers that
+ * need the buffer beyond the current event must lock it.
+ */
+struct wlr_buffer *thumbnail_get(struct output *output, struct view *view,
+	int max_width, int max_height);
+
+/**
+ * thumbnail_is_outdated() - check if the most recently requested thumbnail
+ * of a view needs to be re-rendered because the view has committed new
+ * content since it was captured (or it has never been captured)
+ * @view: view to check
+ */
+bool thumbnail_is_outdated(struct view *view);
+
+/* Drop all cached thumbnails, for example after a GPU reset */
+void thumbnail_reset(struct server *server);
+
+#endif /* LABWC_THUMBNAIL_H */
@@ -10,6 +10,7 @@
 #include "common/edge.h"
 #include "config.h"
 #include "config/types.h"
+#include "window-rules.h"
 
 /*
  * Default minimal window size. Clients can explicitly set smaller values via
@@ -139,6 +140,7 @@ struct view {
 	enum view_type type;
 	const struct view_impl *impl;
 	struct wl_list link;
+	struct wl_list age_link; /* server->views_by_age */
 
 	/* This is cleared when the view is not in the cycle list */
 	struct wl_list cycle_link;
@@ -178,6 +180,9 @@ struct view {
 	char *title;
 	char *app_id; /* WM_CLASS for xwayland windows */
 
+	/* See window_rules_get_property() */
+	struct window_rule_cache rule_cache;
+
 	bool mapped;
 	bool been_mapped;
 	uint64_t creation_id;
@@ -240,6 +245,9 @@ struct view {
 	uint32_t pending_configure_serial;
 	struct wl_event_source *pending_configure_timeout;
 
+	/* Set while a layout transaction waits for the view to resize */
+	bool in_layout_transaction;
+
 	struct ssd *ssd;
 	struct resize_indicator {
 		int width, height;
@@ -272,6 +280,9 @@ struct view {
 		struct wl_array buffers; /* struct lab_data_buffer * */
 	} icon;
 
+	/* used by thumbnail.c, may be NULL */
+	struct thumbnail *thumbnail;
+
 	struct {
 		struct wl_signal new_app_id;
 		struct wl_signal new_title;
@@ -315,6 +326,13 @@ struct xdg_toplevel_view {
 	/* Optional black background fill behind fullscreen view */
 	struct wlr_scene_rect *fullscreen_bg;
 
+	/* Window type as last seen on commit, see handle_commit() */
+	bool is_dialog;
+
+	/* Configure being timed to estimate the client's latency */
+	uint32_t timed_configure_serial;
+	uint64_t timed_configure_nsec;
+
 	/* Events unique to xdg-toplevel views */
 	struct wl_listener set_app_id;
 	struct wl_listener request_show_window_menu;
@@ -382,6 +400,18 @@ bool view_matches_query(struct view *view, struct view_query *query);
 	     view;                                    \
 	     view = view_prev(head, view, criteria))
 
+/**
+ * for_each_view_by_age() - iterate over all views which match criteria
+ * (oldest first)
+ * @view: Iterator.
+ * @head: Head of list to iterate over, normally &server->views_by_age.
+ * @criteria: Criteria to match against.
+ */
+#define for_each_view_by_age(view, head, criteria)           \
+	for (view = view_next_by_age(head, NULL, criteria);  \
+	     view;                                           \
+	     view = view_next_by_age(head, view, criteria))
+
 /**
  * view_next() - Get next view which matches criteria.
  * @head: Head of list to iterate over.
@@ -406,6 +436,18 @@ struct view *view_next(struct wl_list *head, struct view *view,
 struct view *view_prev(struct wl_list *head, struct view *view,
 	enum lab_view_criteria criteria);
 
+/**
+ * view_next_by_age() - Get next younger view which matches criteria.
+ * @head: Head of list to iterate over, linked by view->age_link.
+ * @view: Current view from which to find the next one. If NULL is provided as
+ *	  the view argument, the oldest view will be used.
+ * @criteria: Criteria to match against.
+ *
+ * Returns NULL if there are no views matching the criteria.
+ */
+struct view *view_next_by_age(struct wl_list *head, struct view *view,
+	enum lab_view_criteria criteria);
+
 /**
  * view_array_append() - Append views that match criteria to array
  * @server: server context
@@ -568,6 +610,13 @@ struct view *view_get_modal_dialog(struct view *view);
 
 bool view_on_output(struct view *view, struct output *output);
 
+/**
+ * view_update_outputs() - recompute the outputs the view is on and notify
+ * listeners if they changed
+ * @view: view
+ */
+void view_update_outputs(struct view *view);
+
 /**
  * view_has_strut_partial() - returns true for views that reserve space
  * at a screen edge (e.g. panels). These views are treated as if they
@@ -3,7 +3,9 @@
 #define LABWC_WINDOW_RULES_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <wayland-util.h>
+#include "common/match.h"
 #include "config/types.h"
 
 enum window_rule_event {
@@ -17,6 +19,20 @@ enum property {
 	LAB_PROP_TRUE,
 };
 
+/* Window rule properties, named after their rc.xml attributes */
+enum window_rule_property {
+	LAB_RULE_PROP_SERVER_DECORATION = 0,
+	LAB_RULE_PROP_SKIP_TASKBAR,
+	LAB_RULE_PROP_SKIP_WINDOW_SWITCHER,
+	LAB_RULE_PROP_IGNORE_FOCUS_REQUEST,
+	LAB_RULE_PROP_IGNORE_CONFIGURE_REQUEST,
+	LAB_RULE_PROP_FIXED_POSITION,
+	LAB_RULE_PROP_ICON_PREFER_CLIENT, /* iconPriority */
+	LAB_RULE_PROP_RENDER_DELAY,
+
+	LAB_RULE_PROP_COUNT
+};
+
 /*
  * 'identifier' represents:
  *   - 'app_id' for native Wayland windows
@@ -33,20 +49,43 @@ struct window_rule {
 	enum window_rule_event event;
 	struct wl_list actions;
 
-	enum property server_decoration;
-	enum property skip_taskbar;
-	enum property skip_window_switcher;
-	enum property ignore_focus_request;
-	enum property ignore_configure_request;
-	enum property fixed_position;
-	enum property icon_prefer_client;
+	enum property properties[LAB_RULE_PROP_COUNT];
+
+	/* Compiled from identifier and title when the rule is parsed */
+	struct match_pattern identifier_pattern;
+	struct match_pattern title_pattern;
+	int index; /* position in rc.window_rules, set by window-rules.c */
 
 	struct wl_list link; /* struct rcxml.window_rules */
 };
 
+/*
+ * Properties of a view resolved from all window rules matching it. This
+ * is kept per view and only resolved again when something the rules may
+ * match on has changed.
+ */
+struct window_rule_cache {
+	enum property properties[LAB_RULE_PROP_COUNT];
+	uint32_t generation; /* 0 if not resolved */
+};
+
 struct view;
 
 void window_rules_apply(struct view *view, enum window_rule_event event);
-enum property window_rules_get_property(struct view *view, const char *property);
+enum property window_rules_get_property(struct view *view,
+	enum window_rule_property property);
+
+/**
+ * window_rules_invalidate() - drop the resolved properties of a view
+ * @view: view whose app_id, title or window type has changed, or which
+ * has been created or is about to be destroyed
+ *
+ * When any rule has matchOnce set, the properties of all views depend
+ * on the other views and are dropped as well.
+ */
+void window_rules_invalidate(struct view *view);
+
+/* Drop the resolved properties of all views, e.g. after reconfigure */
+void window_rules_invalidate_all(void);
 
 #endif /* LABWC_WINDOW_RULES_H */
@@ -6,6 +6,7 @@
 #if HAVE_XWAYLAND
 #include "view.h"
 
+struct buf;
 struct wlr_compositor;
 struct wlr_output;
 struct wlr_output_layout;
@@ -41,6 +42,14 @@ struct xwayland_view {
 	struct wlr_xwayland_surface *xwayland_surface;
 	bool focused_before_map;
 
+	/* Geometry to be sent with the next batch of XWM requests */
+	struct wlr_box configure_geo;
+	bool configure_pending;
+
+	/* Sequence number of the pending _NET_WM_ICON request */
+	unsigned int icon_request;
+	bool icon_request_pending;
+
 	/* Events unique to XWayland views */
 	struct wl_listener associate;
 	struct wl_listener dissociate;
@@ -75,9 +84,23 @@ void xwayland_adjust_usable_area(struct view *view,
 
 void xwayland_update_workarea(struct server *server);
 
+/*
+ * Update the window icon sizes X11 icons are decoded for and fetch the
+ * icons again if they changed. Called when the theme or output scales
+ * may have changed.
+ */
+void xwayland_update_icon_sizes(struct server *server);
+
 void xwayland_reset_cursor(struct server *server);
 
+/*
+ * Send all XWM requests which are waiting for the end of the current
+ * event loop iteration and flush the connection to the X server.
+ */
 void xwayland_flush(struct server *server);
 
+/* Print statistics about batched XWM requests, used by IPC */
+void xwayland_print_stats(struct server *server, struct buf *buf);
+
 #endif /* HAVE_XWAYLAND */
 #endif /* LABWC_XWAYLAND_H */
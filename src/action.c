@@ -25,6 +25,7 @@
 #include "magnifier.h"
 #include "menu/menu.h"
 #include "output.h"
+#include "output-stats.h"
 #include "output-virtual.h"
 #include "regions.h"
 #include "ssd.h"
@@ -44,7 +45,7 @@ enum action_arg_type {
 struct action_arg {
 	struct wl_list link;        /* struct action.args */
 
-	char *key;                  /* May be NULL if there is just one arg */
+	enum action_arg_key key;
 	enum action_arg_type type;
 };
 
@@ -135,6 +136,8 @@ enum action_type {
 	ACTION_TYPE_ZOOM_OUT,
 	ACTION_TYPE_WARP_CURSOR,
 	ACTION_TYPE_HIDE_CURSOR,
+	ACTION_TYPE_TOGGLE_OVERVIEW,
+	ACTION_TYPE_TOGGLE_OUTPUT_STATS,
 };
 
 const char *action_names[] = {
@@ -204,18 +207,77 @@ const char *action_names[] = {
 	"ZoomOut",
 	"WarpCursor",
 	"HideCursor",
+	"ToggleOverview",
+	"ToggleOutputStats",
 	NULL
 };
 
+/*
+ * Argument keys are interned when an argument is added, so that running an
+ * action only compares integers.
+ */
+static const char * const action_arg_keys[] = {
+	[ACTION_ARG_AT_CURSOR] = "atCursor",
+	[ACTION_ARG_BOTTOM] = "bottom",
+	[ACTION_ARG_COMBINE] = "combine",
+	[ACTION_ARG_COMMAND] = "command",
+	[ACTION_ARG_DECORATIONS] = "decorations",
+	[ACTION_ARG_DIRECTION] = "direction",
+	[ACTION_ARG_ELSE] = "else",
+	[ACTION_ARG_FOLLOW] = "follow",
+	[ACTION_ARG_FORCE_SSD] = "forceSSD",
+	[ACTION_ARG_HEIGHT] = "height",
+	[ACTION_ARG_IDENTIFIER] = "identifier",
+	[ACTION_ARG_LEFT] = "left",
+	[ACTION_ARG_MENU] = "menu",
+	[ACTION_ARG_MESSAGE_PROMPT] = "message.prompt",
+	[ACTION_ARG_NONE] = "none",
+	[ACTION_ARG_OUTPUT] = "output",
+	[ACTION_ARG_OUTPUT_NAME] = "output_name",
+	[ACTION_ARG_POLICY] = "policy",
+	[ACTION_ARG_QUERY] = "query",
+	[ACTION_ARG_REGION] = "region",
+	[ACTION_ARG_RIGHT] = "right",
+	[ACTION_ARG_SNAP_WINDOWS] = "snapWindows",
+	[ACTION_ARG_THEN] = "then",
+	[ACTION_ARG_TO] = "to",
+	[ACTION_ARG_TOGGLE] = "toggle",
+	[ACTION_ARG_TOP] = "top",
+	[ACTION_ARG_WIDTH] = "width",
+	[ACTION_ARG_WORKSPACE] = "workspace",
+	[ACTION_ARG_WRAP] = "wrap",
+	[ACTION_ARG_X] = "x",
+	[ACTION_ARG_X_POSITION] = "x.position",
+	[ACTION_ARG_Y] = "y",
+	[ACTION_ARG_Y_POSITION] = "y.position",
+};
+
+static enum action_arg_key
+action_arg_key_parse(struct action *action, const char *key)
+{
+	for (size_t i = 1; i < ARRAY_SIZE(action_arg_keys); i++) {
+		if (!strcasecmp(key, action_arg_keys[i])) {
+			return i;
+		}
+	}
+	wlr_log(WLR_ERROR, "Invalid argument for action %s: '%s'",
+		action_names[action->type], key);
+	return ACTION_ARG_UNKNOWN;
+}
+
 void
 action_arg_add_str(struct action *action, const char *key, const char *value)
 {
 	assert(action);
 	assert(key);
 	assert(value && "Tried to add NULL action string argument");
+	enum action_arg_key key_id = action_arg_key_parse(action, key);
+	if (key_id == ACTION_ARG_UNKNOWN) {
+		return;
+	}
 	struct action_arg_str *arg = znew(*arg);
 	arg->base.type = LAB_ACTION_ARG_STR;
-	arg->base.key = xstrdup(key);
+	arg->base.key = key_id;
 	arg->value = xstrdup(value);
 	wl_list_append(&action->args, &arg->base.link);
 }
@@ -225,9 +287,13 @@ action_arg_add_bool(struct action *action, const char *key, bool value)
 {
 	assert(action);
 	assert(key);
+	enum action_arg_key key_id = action_arg_key_parse(action, key);
+	if (key_id == ACTION_ARG_UNKNOWN) {
+		return;
+	}
 	struct action_arg_bool *arg = znew(*arg);
 	arg->base.type = LAB_ACTION_ARG_BOOL;
-	arg->base.key = xstrdup(key);
+	arg->base.key = key_id;
 	arg->value = value;
 	wl_list_append(&action->args, &arg->base.link);
 }
@@ -237,9 +303,13 @@ action_arg_add_int(struct action *action, const char *key, int value)
 {
 	assert(action);
 	assert(key);
+	enum action_arg_key key_id = action_arg_key_parse(action, key);
+	if (key_id == ACTION_ARG_UNKNOWN) {
+		return;
+	}
 	struct action_arg_int *arg = znew(*arg);
 	arg->base.type = LAB_ACTION_ARG_INT;
-	arg->base.key = xstrdup(key);
+	arg->base.key = key_id;
 	arg->value = value;
 	wl_list_append(&action->args, &arg->base.link);
 }
@@ -249,9 +319,13 @@ action_arg_add_list(struct action *action, const char *key, enum action_arg_type
 {
 	assert(action);
 	assert(key);
+	enum action_arg_key key_id = action_arg_key_parse(action, key);
+	if (key_id == ACTION_ARG_UNKNOWN) {
+		return;
+	}
 	struct action_arg_list *arg = znew(*arg);
 	arg->base.type = type;
-	arg->base.key = xstrdup(key);
+	arg->base.key = key_id;
 	wl_list_init(&arg->value);
 	wl_list_append(&action->args, &arg->base.link);
 }
@@ -269,13 +343,13 @@ action_arg_add_actionlist(struct action *action, const char *key)
 }
 
 static void *
-action_get_arg(struct action *action, const char *key, enum action_arg_type type)
+action_get_arg(struct action *action, enum action_arg_key key,
+		enum action_arg_type type)
 {
 	assert(action);
-	assert(key);
 	struct action_arg *arg;
 	wl_list_for_each(arg, &action->args, link) {
-		if (!strcasecmp(key, arg->key) && arg->type == type) {
+		if (arg->key == key && arg->type == type) {
 			return arg;
 		}
 	}
@@ -283,35 +357,35 @@ action_get_arg(struct action *action, const char *key, enum action_arg_type type
 }
 
 const char *
-action_get_str(struct action *action, const char *key, const char *default_value)
+action_get_str(struct action *action, enum action_arg_key key, const char *default_value)
 {
 	struct action_arg_str *arg = action_get_arg(action, key, LAB_ACTION_ARG_STR);
 	return arg ? arg->value : default_value;
 }
 
 static bool
-action_get_bool(struct action *action, const char *key, bool default_value)
+action_get_bool(struct action *action, enum action_arg_key key, bool default_value)
 {
 	struct action_arg_bool *arg = action_get_arg(action, key, LAB_ACTION_ARG_BOOL);
 	return arg ? arg->value : default_value;
 }
 
 static int
-action_get_int(struct action *action, const char *key, int default_value)
+action_get_int(struct action *action, enum action_arg_key key, int default_value)
 {
 	struct action_arg_int *arg = action_get_arg(action, key, LAB_ACTION_ARG_INT);
 	return arg ? arg->value : default_value;
 }
 
 struct wl_list *
-action_get_querylist(struct action *action, const char *key)
+action_get_querylist(struct action *action, enum action_arg_key key)
 {
 	struct action_arg_list *arg = action_get_arg(action, key, LAB_ACTION_ARG_QUERY_LIST);
 	return arg ? &arg->value : NULL;
 }
 
 struct wl_list *
-action_get_actionlist(struct action *action, const char *key)
+action_get_actionlist(struct action *action, enum action_arg_key key)
 {
 	struct action_arg_list *arg = action_get_arg(action, key, LAB_ACTION_ARG_ACTION_LIST);
 	return arg ? &arg->value : NULL;
@@ -636,13 +710,16 @@ action_list_is_valid(struct wl_list *actions)
 static bool
 action_branches_are_valid(struct action *action)
 {
-	static const char * const branches[] = { "then", "else", "none" };
+	static const enum action_arg_key branches[] = {
+		ACTION_ARG_THEN, ACTION_ARG_ELSE, ACTION_ARG_NONE,
+	};
 	for (size_t i = 0; i < ARRAY_SIZE(branches); i++) {
 		struct wl_list *children =
 			action_get_actionlist(action, branches[i]);
 		if (children && !action_list_is_valid(children)) {
 			wlr_log(WLR_ERROR, "Invalid action in %s '%s' branch",
-				action_names[action->type], branches[i]);
+				action_names[action->type],
+				action_arg_keys[branches[i]]);
 			return false;
 		}
 	}
@@ -653,31 +730,31 @@ action_branches_are_valid(struct action *action)
 bool
 action_is_valid(struct action *action)
 {
-	const char *arg_name = NULL;
+	enum action_arg_key arg_key = ACTION_ARG_UNKNOWN;
 	enum action_arg_type arg_type = LAB_ACTION_ARG_STR;
 
 	switch (action->type) {
 	case ACTION_TYPE_EXECUTE:
-		arg_name = "command";
+		arg_key = ACTION_ARG_COMMAND;
 		break;
 	case ACTION_TYPE_MOVE_TO_EDGE:
 	case ACTION_TYPE_TOGGLE_SNAP_TO_EDGE:
 	case ACTION_TYPE_SNAP_TO_EDGE:
 	case ACTION_TYPE_GROW_TO_EDGE:
 	case ACTION_TYPE_SHRINK_TO_EDGE:
-		arg_name = "direction";
+		arg_key = ACTION_ARG_DIRECTION;
 		arg_type = LAB_ACTION_ARG_INT;
 		break;
 	case ACTION_TYPE_SHOW_MENU:
-		arg_name = "menu";
+		arg_key = ACTION_ARG_MENU;
 		break;
 	case ACTION_TYPE_GO_TO_DESKTOP:
 	case ACTION_TYPE_SEND_TO_DESKTOP:
-		arg_name = "to";
+		arg_key = ACTION_ARG_TO;
 		break;
 	case ACTION_TYPE_TOGGLE_SNAP_TO_REGION:
 	case ACTION_TYPE_SNAP_TO_REGION:
-		arg_name = "region";
+		arg_key = ACTION_ARG_REGION;
 		break;
 	case ACTION_TYPE_IF:
 	case ACTION_TYPE_FOR_EACH:
@@ -687,12 +764,12 @@ action_is_valid(struct action *action)
 		return true;
 	}
 
-	if (action_get_arg(action, arg_name, arg_type)) {
+	if (action_get_arg(action, arg_key, arg_type)) {
 		return true;
 	}
 
 	wlr_log(WLR_ERROR, "Missing required argument for %s: %s",
-		action_names[action->type], arg_name);
+		action_names[action->type], action_arg_keys[arg_key]);
 	return false;
 }
 
@@ -709,7 +786,6 @@ action_free(struct action *action)
 	struct action_arg *arg, *arg_tmp;
 	wl_list_for_each_safe(arg, arg_tmp, &action->args, link) {
 		wl_list_remove(&arg->link);
-		zfree(arg->key);
 		if (arg->type == LAB_ACTION_ARG_STR) {
 			struct action_arg_str *str_arg = (struct action_arg_str *)arg;
 			zfree(str_arg->value);
@@ -905,7 +981,7 @@ print_prompt_command(struct buf *buf, const char *format,
 		switch (*p) {
 		case 'm':
 			buf_add(buf, action_get_str(action,
-					"message.prompt", "Choose wisely"));
+					ACTION_ARG_MESSAGE_PROMPT, "Choose wisely"));
 			break;
 		case 'n':
 			buf_add(buf, _("No"));
@@ -985,12 +1061,12 @@ action_check_prompt_result(pid_t pid, int exit_code)
 		struct wl_list *actions = NULL;
 		if (exit_code == LAB_EXIT_SUCCESS) {
 			wlr_log(WLR_INFO, "Selected the 'then' branch");
-			actions = action_get_actionlist(prompt->action, "then");
+			actions = action_get_actionlist(prompt->action, ACTION_ARG_THEN);
 		} else if (exit_code == LAB_EXIT_CANCELLED) {
 			/* no-op */
 		} else {
 			wlr_log(WLR_INFO, "Selected the 'else' branch");
-			actions = action_get_actionlist(prompt->action, "else");
+			actions = action_get_actionlist(prompt->action, ACTION_ARG_ELSE);
 		}
 		if (actions) {
 			wlr_log(WLR_INFO, "Running actions");
@@ -1010,7 +1086,7 @@ match_queries(struct view *view, struct action *action)
 {
 	assert(view);
 
-	struct wl_list *queries = action_get_querylist(action, "query");
+	struct wl_list *queries = action_get_querylist(action, ACTION_ARG_QUERY);
 	if (!queries) {
 		return true;
 	}
@@ -1029,15 +1105,15 @@ static struct output *
 get_target_output(struct output *output, struct server *server,
 	struct action *action)
 {
-	const char *output_name = action_get_str(action, "output", NULL);
+	const char *output_name = action_get_str(action, ACTION_ARG_OUTPUT, NULL);
 	struct output *target = NULL;
 
 	if (output_name) {
 		target = output_from_name(server, output_name);
 	} else {
 		enum lab_edge edge =
-			action_get_int(action, "direction", LAB_EDGE_NONE);
-		bool wrap = action_get_bool(action, "wrap", false);
+			action_get_int(action, ACTION_ARG_DIRECTION, LAB_EDGE_NONE);
+		bool wrap = action_get_bool(action, ACTION_ARG_WRAP, false);
 		target = output_get_adjacent(output, edge, wrap);
 	}
 
@@ -1113,7 +1189,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 		break;
 	case ACTION_TYPE_EXECUTE: {
 		struct buf cmd = BUF_INIT;
-		buf_add(&cmd, action_get_str(action, "command", NULL));
+		buf_add(&cmd, action_get_str(action, ACTION_ARG_COMMAND, NULL));
 		buf_expand_tilde(&cmd);
 		spawn_async_no_shell(cmd.data);
 		buf_reset(&cmd);
@@ -1125,8 +1201,8 @@ run_action(struct view *view, struct server *server, struct action *action,
 	case ACTION_TYPE_MOVE_TO_EDGE:
 		if (view) {
 			/* Config parsing makes sure that direction is a valid direction */
-			enum lab_edge edge = action_get_int(action, "direction", 0);
-			bool snap_to_windows = action_get_bool(action, "snapWindows", true);
+			enum lab_edge edge = action_get_int(action, ACTION_ARG_DIRECTION, 0);
+			bool snap_to_windows = action_get_bool(action, ACTION_ARG_SNAP_WINDOWS, true);
 			view_move_to_edge(view, edge, snap_to_windows);
 		}
 		break;
@@ -1134,7 +1210,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 	case ACTION_TYPE_SNAP_TO_EDGE:
 		if (view) {
 			/* Config parsing makes sure that direction is a valid direction */
-			enum lab_edge edge = action_get_int(action, "direction", 0);
+			enum lab_edge edge = action_get_int(action, ACTION_ARG_DIRECTION, 0);
 			if (action->type == ACTION_TYPE_TOGGLE_SNAP_TO_EDGE
 					&& view->maximized == VIEW_AXIS_NONE
 					&& !view->fullscreen
@@ -1144,7 +1220,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 				view_apply_natural_geometry(view);
 				break;
 			}
-			bool combine = action_get_bool(action, "combine", false);
+			bool combine = action_get_bool(action, ACTION_ARG_COMBINE, false);
 			view_snap_to_edge(view, edge, /*across_outputs*/ true,
 				combine);
 		}
@@ -1152,14 +1228,14 @@ run_action(struct view *view, struct server *server, struct action *action,
 	case ACTION_TYPE_GROW_TO_EDGE:
 		if (view) {
 			/* Config parsing makes sure that direction is a valid direction */
-			enum lab_edge edge = action_get_int(action, "direction", 0);
+			enum lab_edge edge = action_get_int(action, ACTION_ARG_DIRECTION, 0);
 			view_grow_to_edge(view, edge);
 		}
 		break;
 	case ACTION_TYPE_SHRINK_TO_EDGE:
 		if (view) {
 			/* Config parsing makes sure that direction is a valid direction */
-			enum lab_edge edge = action_get_int(action, "direction", 0);
+			enum lab_edge edge = action_get_int(action, ACTION_ARG_DIRECTION, 0);
 			view_shrink_to_edge(view, edge);
 		}
 		break;
@@ -1168,11 +1244,11 @@ run_action(struct view *view, struct server *server, struct action *action,
 		enum lab_cycle_dir dir = (action->type == ACTION_TYPE_NEXT_WINDOW) ?
 			LAB_CYCLE_DIR_FORWARD : LAB_CYCLE_DIR_BACKWARD;
 		struct cycle_filter filter = {
-			.workspace = action_get_int(action, "workspace",
+			.workspace = action_get_int(action, ACTION_ARG_WORKSPACE,
 				rc.window_switcher.workspace_filter),
-			.output = action_get_int(action, "output",
+			.output = action_get_int(action, ACTION_ARG_OUTPUT,
 				CYCLE_OUTPUT_ALL),
-			.app_id = action_get_int(action, "identifier",
+			.app_id = action_get_int(action, ACTION_ARG_IDENTIFIER,
 				CYCLE_APP_ID_ALL),
 		};
 		if (server->input_mode == LAB_INPUT_STATE_CYCLE) {
@@ -1187,29 +1263,29 @@ run_action(struct view *view, struct server *server, struct action *action,
 		break;
 	case ACTION_TYPE_SHOW_MENU:
 		show_menu(server, view, ctx,
-			action_get_str(action, "menu", NULL),
-			action_get_bool(action, "atCursor", true),
-			action_get_str(action, "x.position", NULL),
-			action_get_str(action, "y.position", NULL));
+			action_get_str(action, ACTION_ARG_MENU, NULL),
+			action_get_bool(action, ACTION_ARG_AT_CURSOR, true),
+			action_get_str(action, ACTION_ARG_X_POSITION, NULL),
+			action_get_str(action, ACTION_ARG_Y_POSITION, NULL));
 		break;
 	case ACTION_TYPE_TOGGLE_MAXIMIZE:
 		if (view) {
 			enum view_axis axis = action_get_int(action,
-				"direction", VIEW_AXIS_BOTH);
+				ACTION_ARG_DIRECTION, VIEW_AXIS_BOTH);
 			view_toggle_maximize(view, axis);
 		}
 		break;
 	case ACTION_TYPE_MAXIMIZE:
 		if (view) {
 			enum view_axis axis = action_get_int(action,
-				"direction", VIEW_AXIS_BOTH);
+				ACTION_ARG_DIRECTION, VIEW_AXIS_BOTH);
 			view_maximize(view, axis);
 		}
 		break;
 	case ACTION_TYPE_UNMAXIMIZE:
 		if (view) {
 			enum view_axis axis = action_get_int(action,
-				"direction", VIEW_AXIS_BOTH);
+				ACTION_ARG_DIRECTION, VIEW_AXIS_BOTH);
 			view_maximize(view, view->maximized & ~axis);
 		}
 		break;
@@ -1221,9 +1297,9 @@ run_action(struct view *view, struct server *server, struct action *action,
 	case ACTION_TYPE_SET_DECORATIONS:
 		if (view) {
 			enum lab_ssd_mode mode = action_get_int(action,
-				"decorations", LAB_SSD_MODE_FULL);
+				ACTION_ARG_DECORATIONS, LAB_SSD_MODE_FULL);
 			bool force_ssd = action_get_bool(action,
-				"forceSSD", false);
+				ACTION_ARG_FORCE_SSD, false);
 			view_set_decorations(view, mode, force_ssd);
 		}
 		break;
@@ -1292,7 +1368,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 			 * the current cursor position (existing behaviour).
 			 */
 			enum lab_edge resize_edges =
-				action_get_int(action, "direction", LAB_EDGE_NONE);
+				action_get_int(action, ACTION_ARG_DIRECTION, LAB_EDGE_NONE);
 			/*
 			 * If triggered by mousebind, grab context was already
 			 * set by button press handling. For keybind-triggered
@@ -1307,25 +1383,25 @@ run_action(struct view *view, struct server *server, struct action *action,
 		break;
 	case ACTION_TYPE_RESIZE_RELATIVE:
 		if (view) {
-			int left = action_get_int(action, "left", 0);
-			int right = action_get_int(action, "right", 0);
-			int top = action_get_int(action, "top", 0);
-			int bottom = action_get_int(action, "bottom", 0);
+			int left = action_get_int(action, ACTION_ARG_LEFT, 0);
+			int right = action_get_int(action, ACTION_ARG_RIGHT, 0);
+			int top = action_get_int(action, ACTION_ARG_TOP, 0);
+			int bottom = action_get_int(action, ACTION_ARG_BOTTOM, 0);
 			view_resize_relative(view, left, right, top, bottom);
 		}
 		break;
 	case ACTION_TYPE_MOVETO:
 		if (view) {
-			int x = action_get_int(action, "x", 0);
-			int y = action_get_int(action, "y", 0);
+			int x = action_get_int(action, ACTION_ARG_X, 0);
+			int y = action_get_int(action, ACTION_ARG_Y, 0);
 			struct border margin = ssd_thickness(view);
 			view_move(view, x + margin.left, y + margin.top);
 		}
 		break;
 	case ACTION_TYPE_RESIZETO:
 		if (view) {
-			int width = action_get_int(action, "width", 0);
-			int height = action_get_int(action, "height", 0);
+			int width = action_get_int(action, ACTION_ARG_WIDTH, 0);
+			int height = action_get_int(action, ACTION_ARG_HEIGHT, 0);
 
 			/*
 			 * To support only setting one of width/height
@@ -1344,8 +1420,8 @@ run_action(struct view *view, struct server *server, struct action *action,
 		break;
 	case ACTION_TYPE_MOVE_RELATIVE:
 		if (view) {
-			int x = action_get_int(action, "x", 0);
-			int y = action_get_int(action, "y", 0);
+			int x = action_get_int(action, ACTION_ARG_X, 0);
+			int y = action_get_int(action, ACTION_ARG_Y, 0);
 			view_move_relative(view, x, y);
 		}
 		break;
@@ -1364,8 +1440,8 @@ run_action(struct view *view, struct server *server, struct action *action,
 		/* Falls through to GoToDesktop */
 	case ACTION_TYPE_GO_TO_DESKTOP: {
 		bool follow = true;
-		bool wrap = action_get_bool(action, "wrap", true);
-		const char *to = action_get_str(action, "to", NULL);
+		bool wrap = action_get_bool(action, ACTION_ARG_WRAP, true);
+		const char *to = action_get_str(action, ACTION_ARG_TO, NULL);
 		/*
 		 * `to` is always != NULL here because otherwise we would have
 		 * removed the action during the initial parsing step as it is
@@ -1374,7 +1450,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 		struct workspace *target_workspace = workspaces_find(
 			server->workspaces.current, to, wrap);
 		if (action->type == ACTION_TYPE_GO_TO_DESKTOP) {
-			bool toggle = action_get_bool(action, "toggle", false);
+			bool toggle = action_get_bool(action, ACTION_ARG_TOGGLE, false);
 			if (target_workspace == server->workspaces.current
 				&& toggle) {
 				target_workspace = server->workspaces.last;
@@ -1385,7 +1461,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 		}
 		if (action->type == ACTION_TYPE_SEND_TO_DESKTOP) {
 			view_move_to_workspace(view, target_workspace);
-			follow = action_get_bool(action, "follow", true);
+			follow = action_get_bool(action, ACTION_ARG_FOLLOW, true);
 
 			/* Ensure that the focus is not on another desktop */
 			if (!follow && server->active_view == view) {
@@ -1424,7 +1500,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 		if (!output_is_usable(output)) {
 			break;
 		}
-		const char *region_name = action_get_str(action, "region", NULL);
+		const char *region_name = action_get_str(action, ACTION_ARG_REGION, NULL);
 		struct region *region = regions_from_name(region_name, output);
 		if (region) {
 			if (action->type == ACTION_TYPE_TOGGLE_SNAP_TO_REGION
@@ -1465,7 +1541,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 	}
 	case ACTION_TYPE_IF: {
 		/* At least one of the queries was matched or there was no query */
-		if (action_get_str(action, "message.prompt", NULL)) {
+		if (action_get_str(action, ACTION_ARG_MESSAGE_PROMPT, NULL)) {
 			/*
 			 * We delay the selection and execution of the
 			 * branch until we get a response from the user.
@@ -1474,9 +1550,9 @@ run_action(struct view *view, struct server *server, struct action *action,
 		} else if (view) {
 			struct wl_list *actions;
 			if (match_queries(view, action)) {
-				actions = action_get_actionlist(action, "then");
+				actions = action_get_actionlist(action, ACTION_ARG_THEN);
 			} else {
-				actions = action_get_actionlist(action, "else");
+				actions = action_get_actionlist(action, ACTION_ARG_ELSE);
 			}
 			if (actions) {
 				actions_run(view, server, actions, ctx);
@@ -1496,9 +1572,9 @@ run_action(struct view *view, struct server *server, struct action *action,
 		wl_array_for_each(item, &views) {
 			if (match_queries(*item, action)) {
 				matches = true;
-				actions = action_get_actionlist(action, "then");
+				actions = action_get_actionlist(action, ACTION_ARG_THEN);
 			} else {
-				actions = action_get_actionlist(action, "else");
+				actions = action_get_actionlist(action, ACTION_ARG_ELSE);
 			}
 			if (actions) {
 				actions_run(*item, server, actions, ctx);
@@ -1506,7 +1582,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 		}
 		wl_array_release(&views);
 		if (!matches) {
-			actions = action_get_actionlist(action, "none");
+			actions = action_get_actionlist(action, ACTION_ARG_NONE);
 			if (actions) {
 				actions_run(view, server, actions, NULL);
 			}
@@ -1516,7 +1592,7 @@ run_action(struct view *view, struct server *server, struct action *action,
 	case ACTION_TYPE_VIRTUAL_OUTPUT_ADD: {
 		/* TODO: rename this argument to "outputName" */
 		const char *output_name =
-			action_get_str(action, "output_name", NULL);
+			action_get_str(action, ACTION_ARG_OUTPUT_NAME, NULL);
 		output_virtual_add(server, output_name,
 				/*store_wlr_output*/ NULL);
 		break;
@@ -1524,14 +1600,14 @@ run_action(struct view *view, struct server *server, struct action *action,
 	case ACTION_TYPE_VIRTUAL_OUTPUT_REMOVE: {
 		/* TODO: rename this argument to "outputName" */
 		const char *output_name =
-			action_get_str(action, "output_name", NULL);
+			action_get_str(action, ACTION_ARG_OUTPUT_NAME, NULL);
 		output_virtual_remove(server, output_name);
 		break;
 	}
 	case ACTION_TYPE_AUTO_PLACE:
 		if (view) {
 			enum lab_placement_policy policy =
-				action_get_int(action, "policy", LAB_PLACE_AUTOMATIC);
+				action_get_int(action, ACTION_ARG_POLICY, LAB_PLACE_AUTOMATIC);
 			view_place_by_policy(view,
 				/* allow_cursor */ true, policy);
 		}
@@ -1600,15 +1676,26 @@ run_action(struct view *view, struct server *server, struct action *action,
 		magnifier_set_scale(server, MAGNIFY_DECREASE);
 		break;
 	case ACTION_TYPE_WARP_CURSOR: {
-		const char *to = action_get_str(action, "to", "output");
-		const char *x = action_get_str(action, "x", "center");
-		const char *y = action_get_str(action, "y", "center");
+		const char *to = action_get_str(action, ACTION_ARG_TO, "output");
+		const char *x = action_get_str(action, ACTION_ARG_X, "center");
+		const char *y = action_get_str(action, ACTION_ARG_Y, "center");
 		warp_cursor(server, view, to, x, y);
 		break;
 	}
 	case ACTION_TYPE_HIDE_CURSOR:
 		cursor_set_visible(&server->seat, false);
 		break;
+	case ACTION_TYPE_TOGGLE_OVERVIEW:
+		if (server->input_mode == LAB_INPUT_STATE_CYCLE
+				&& server->cycle.overview) {
+			cycle_finish(server, /*switch_focus*/ false);
+		} else {
+			cycle_overview_begin(server);
+		}
+		break;
+	case ACTION_TYPE_TOGGLE_OUTPUT_STATS:
+		output_stats_toggle_hud(server);
+		break;
 	case ACTION_TYPE_INVALID:
 		wlr_log(WLR_ERROR, "Not executing unknown action");
 		break;
@@ -1645,9 +1732,11 @@ actions_run(struct view *activator, struct server *server,
 	wl_list_for_each(action, actions, link) {
 		if (server->input_mode == LAB_INPUT_STATE_CYCLE
 				&& action->type != ACTION_TYPE_NEXT_WINDOW
-				&& action->type != ACTION_TYPE_PREVIOUS_WINDOW) {
-			wlr_log(WLR_INFO, "Only NextWindow or PreviousWindow "
-				"actions are accepted while window switching.");
+				&& action->type != ACTION_TYPE_PREVIOUS_WINDOW
+				&& action->type != ACTION_TYPE_TOGGLE_OVERVIEW) {
+			wlr_log(WLR_INFO, "Only NextWindow, PreviousWindow or "
+				"ToggleOverview actions are accepted while "
+				"window switching.");
 			continue;
 		}
 
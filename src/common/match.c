@@ -2,9 +2,82 @@
 
 #include "common/match.h"
 #include <fnmatch.h>
+#include <string.h>
+#include <strings.h>
+#include "common/mem.h"
 
 bool
 match_glob(const char *pattern, const char *string)
 {
 	return fnmatch(pattern, string, FNM_CASEFOLD) == 0;
 }
+
+/*
+ * String comparison only agrees with fnmatch(FNM_CASEFOLD) for ASCII,
+ * as fnmatch() folds the case of multibyte characters too.
+ */
+static bool
+is_plain(const char *str, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = str[i];
+		if (c >= 0x80 || strchr("*?[\\", c)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+match_pattern_compile(struct match_pattern *pattern, const char *glob)
+{
+	size_t len = strlen(glob);
+	size_t start = strspn(glob, "*");
+
+	if (len && start == len) {
+		*pattern = (struct match_pattern){ .type = LAB_MATCH_ANY };
+		return;
+	}
+	if (is_plain(glob, len)) {
+		pattern->type = LAB_MATCH_LITERAL;
+	} else if (start == 1 && is_plain(glob + 1, len - 1)) {
+		pattern->type = LAB_MATCH_SUFFIX;
+		glob++;
+		len--;
+	} else if (glob[len - 1] == '*' && is_plain(glob, len - 1)) {
+		pattern->type = LAB_MATCH_PREFIX;
+		len--;
+	} else {
+		pattern->type = LAB_MATCH_GLOB;
+	}
+	pattern->str = xstrdup(glob);
+	pattern->str[len] = '\0';
+	pattern->len = len;
+}
+
+void
+match_pattern_finish(struct match_pattern *pattern)
+{
+	zfree(pattern->str);
+}
+
+bool
+match_pattern_test(const struct match_pattern *pattern, const char *string)
+{
+	size_t len;
+	switch (pattern->type) {
+	case LAB_MATCH_ANY:
+		return true;
+	case LAB_MATCH_LITERAL:
+		return !strcasecmp(pattern->str, string);
+	case LAB_MATCH_PREFIX:
+		return !strncasecmp(pattern->str, string, pattern->len);
+	case LAB_MATCH_SUFFIX:
+		len = strlen(string);
+		return len >= pattern->len && !strcasecmp(pattern->str,
+			string + len - pattern->len);
+	case LAB_MATCH_GLOB:
+		return match_glob(pattern->str, string);
+	}
+	return false;
+}
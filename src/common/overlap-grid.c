@@ -0,0 +1,347 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include "common/overlap-grid.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include "common/macros.h"
+#include "common/mem.h"
+
+/*
+ * The rectangles are reduced to an irregular grid which divides @bounds
+ * by extending the edges of every rectangle to infinity. Each cell of
+ * the grid is either completely covered by a rectangle or not at all.
+ *
+ * The number of rectangles covering each cell is then integrated into a
+ * summed-area table (2D prefix sums), from which the overlap of any
+ * rectangle with the grid can be computed in constant time.
+ */
+struct grid {
+	int *rows; /* sorted y coordinates of the grid lines */
+	int *cols; /* sorted x coordinates of the grid lines */
+	int nr_rows;
+	int nr_cols;
+	/* Number of rectangles covering cell (r, c), (nr_rows - 1) x (nr_cols - 1) */
+	int *count;
+	/* Overlap within [cols[0], cols[c]) x [rows[0], rows[r]), nr_rows x nr_cols */
+	int64_t *sat;
+	/*
+	 * Overlap per unit of width within column c above row r, and per
+	 * unit of height within row r left of column c. These interpolate
+	 * the table within a cell without any divisions.
+	 */
+	int64_t *col_sat;
+	int64_t *row_sat;
+};
+
+/* A position on one axis, relative to the grid line before it */
+struct grid_pos {
+	int index;
+	int offset;
+};
+
+#define COUNT(g, r, c) (g)->count[(r) * ((g)->nr_cols - 1) + (c)]
+#define SAT(g, r, c) (g)->sat[(r) * (g)->nr_cols + (c)]
+#define COL_SAT(g, r, c) (g)->col_sat[(r) * (g)->nr_cols + (c)]
+#define ROW_SAT(g, r, c) (g)->row_sat[(r) * (g)->nr_cols + (c)]
+
+static int
+compare_ints(const void *a, const void *b)
+{
+	int ia = *(const int *)a;
+	int ib = *(const int *)b;
+	return (ia > ib) - (ia < ib);
+}
+
+/* Sort and de-duplicate a list of grid lines, returning their number */
+static int
+order_lines(int *lines, int nr_lines)
+{
+	qsort(lines, nr_lines, sizeof(int), compare_ints);
+
+	int nr_unique = 0;
+	for (int i = 0; i < nr_lines; i++) {
+		if (!nr_unique || lines[i] != lines[nr_unique - 1]) {
+			lines[nr_unique++] = lines[i];
+		}
+	}
+	return nr_unique;
+}
+
+/*
+ * Returns the index of the grid line at or before @val, clamped to the
+ * cells of the grid so that the cell (index, index + 1) always exists.
+ */
+static int
+find_cell(const int *lines, int nr_lines, int val)
+{
+	int l = 0;
+	int r = nr_lines;
+	while (l < r) {
+		int m = (l + r) / 2;
+		if (lines[m] > val) {
+			r = m;
+		} else {
+			l = m + 1;
+		}
+	}
+	return MAX(0, MIN(r - 1, nr_lines - 2));
+}
+
+static struct grid_pos
+get_pos(const int *lines, int nr_lines, int val)
+{
+	int index = find_cell(lines, nr_lines, val);
+	return (struct grid_pos){
+		.index = index,
+		.offset = val - lines[index],
+	};
+}
+
+static void
+build_grid(struct grid *grid, const struct wlr_box *bounds,
+		const struct wlr_box *rects, int nr_rects)
+{
+	/* Two lines per rectangle plus the edges of the bounds */
+	grid->rows = xzalloc((2 * nr_rects + 2) * sizeof(int));
+	grid->cols = xzalloc((2 * nr_rects + 2) * sizeof(int));
+
+	int right = bounds->x + bounds->width;
+	int bottom = bounds->y + bounds->height;
+	int nr_rows = 0;
+	int nr_cols = 0;
+	grid->cols[nr_cols++] = bounds->x;
+	grid->cols[nr_cols++] = right;
+	grid->rows[nr_rows++] = bounds->y;
+	grid->rows[nr_rows++] = bottom;
+
+	for (int i = 0; i < nr_rects; i++) {
+		const struct wlr_box *rect = &rects[i];
+		int x2 = rect->x + rect->width;
+		int y2 = rect->y + rect->height;
+		if (rect->x > bounds->x && rect->x < right) {
+			grid->cols[nr_cols++] = rect->x;
+		}
+		if (x2 > bounds->x && x2 < right) {
+			grid->cols[nr_cols++] = x2;
+		}
+		if (rect->y > bounds->y && rect->y < bottom) {
+			grid->rows[nr_rows++] = rect->y;
+		}
+		if (y2 > bounds->y && y2 < bottom) {
+			grid->rows[nr_rows++] = y2;
+		}
+	}
+	grid->nr_rows = order_lines(grid->rows, nr_rows);
+	grid->nr_cols = order_lines(grid->cols, nr_cols);
+
+	/*
+	 * Count the rectangles covering each cell using a 2D difference
+	 * array: each rectangle only marks its corners, and the prefix sums
+	 * over the array yield the counts. This is O(cells + rectangles)
+	 * rather than O(cells * rectangles).
+	 */
+	int *diff = xzalloc((size_t)grid->nr_rows * grid->nr_cols * sizeof(int));
+	for (int i = 0; i < nr_rects; i++) {
+		const struct wlr_box *rect = &rects[i];
+		int x1 = MAX(rect->x, bounds->x);
+		int y1 = MAX(rect->y, bounds->y);
+		int x2 = MIN(rect->x + rect->width, right);
+		int y2 = MIN(rect->y + rect->height, bottom);
+		if (x1 >= x2 || y1 >= y2) {
+			continue;
+		}
+		/* The clipped edges are grid lines by construction */
+		int fc = get_pos(grid->cols, grid->nr_cols, x1).index;
+		int fr = get_pos(grid->rows, grid->nr_rows, y1).index;
+		int lc = x2 == right ? grid->nr_cols - 1
+			: get_pos(grid->cols, grid->nr_cols, x2).index;
+		int lr = y2 == bottom ? grid->nr_rows - 1
+			: get_pos(grid->rows, grid->nr_rows, y2).index;
+		diff[fr * grid->nr_cols + fc]++;
+		diff[fr * grid->nr_cols + lc]--;
+		diff[lr * grid->nr_cols + fc]--;
+		diff[lr * grid->nr_cols + lc]++;
+	}
+
+	grid->count = xzalloc((size_t)(grid->nr_rows - 1)
+		* (grid->nr_cols - 1) * sizeof(int));
+	size_t sat_size = (size_t)grid->nr_rows * grid->nr_cols * sizeof(int64_t);
+	grid->sat = xzalloc(sat_size);
+	grid->col_sat = xzalloc(sat_size);
+	grid->row_sat = xzalloc(sat_size);
+	for (int r = 0; r < grid->nr_rows - 1; r++) {
+		int64_t height = grid->rows[r + 1] - grid->rows[r];
+		int count = 0; /* prefix sum of this row of diff */
+		for (int c = 0; c < grid->nr_cols - 1; c++) {
+			count += diff[r * grid->nr_cols + c];
+			int above = r > 0 ? COUNT(grid, r - 1, c) : 0;
+			/* Prefix sum along the column */
+			COUNT(grid, r, c) = count + above;
+			int64_t width = grid->cols[c + 1] - grid->cols[c];
+			COL_SAT(grid, r + 1, c) = COL_SAT(grid, r, c)
+				+ COUNT(grid, r, c) * height;
+			ROW_SAT(grid, r, c + 1) = ROW_SAT(grid, r, c)
+				+ COUNT(grid, r, c) * width;
+			SAT(grid, r + 1, c + 1) = SAT(grid, r + 1, c)
+				+ COL_SAT(grid, r + 1, c) * width;
+		}
+	}
+	free(diff);
+}
+
+static void
+destroy_grid(struct grid *grid)
+{
+	zfree(grid->rows);
+	zfree(grid->cols);
+	zfree(grid->count);
+	zfree(grid->sat);
+	zfree(grid->col_sat);
+	zfree(grid->row_sat);
+}
+
+/*
+ * Candidate positions along one axis: for every cell the region either
+ * starts at the cell's first grid line (forward) or ends at its second
+ * one (backward). Positions are precomputed as grid positions so that
+ * the search itself is just arithmetic.
+ */
+struct candidate {
+	int start;
+	bool valid;
+	struct grid_pos pos[2]; /* start and end of the region */
+};
+
+static void
+get_candidates(const int *lines, int nr_lines, int size,
+		struct candidate *candidates)
+{
+	int min = lines[0];
+	int max = lines[nr_lines - 1];
+	for (int i = 0; i < nr_lines - 1; i++) {
+		for (int dir = 0; dir < 2; dir++) {
+			struct candidate *cand = &candidates[2 * i + dir];
+			cand->start = dir == 0 ? lines[i] : lines[i + 1] - size;
+			int end = cand->start + size;
+			cand->valid = cand->start >= min && end <= max;
+			if (cand->valid) {
+				cand->pos[0] = get_pos(lines, nr_lines, cand->start);
+				cand->pos[1] = get_pos(lines, nr_lines, end);
+			}
+		}
+	}
+}
+
+/*
+ * The summed-area table reduced to the horizontal strip covered by a row
+ * candidate: the overlap of the strip left of each column line, and the
+ * overlap per unit of width within each column. The overlap of a region
+ * is then the difference of two interpolated values.
+ */
+struct strip {
+	int64_t *area; /* nr_cols */
+	int64_t *per_width; /* nr_cols - 1 */
+};
+
+static void
+build_strip(const struct grid *grid, const struct candidate *row,
+		struct strip *strip)
+{
+	int r0 = row->pos[0].index;
+	int r1 = row->pos[1].index;
+	int64_t dy0 = row->pos[0].offset;
+	int64_t dy1 = row->pos[1].offset;
+
+	for (int c = 0; c < grid->nr_cols; c++) {
+		strip->area[c] = SAT(grid, r1, c) + dy1 * ROW_SAT(grid, r1, c)
+			- SAT(grid, r0, c) - dy0 * ROW_SAT(grid, r0, c);
+	}
+	for (int c = 0; c < grid->nr_cols - 1; c++) {
+		strip->per_width[c] =
+			COL_SAT(grid, r1, c) + dy1 * COUNT(grid, r1, c)
+			- COL_SAT(grid, r0, c) - dy0 * COUNT(grid, r0, c);
+	}
+}
+
+static int64_t
+strip_get_overlap(const struct strip *strip, const struct grid_pos *x)
+{
+	return strip->area[x[1].index]
+		+ x[1].offset * strip->per_width[x[1].index]
+		- strip->area[x[0].index]
+		- x[0].offset * strip->per_width[x[0].index];
+}
+
+bool
+overlap_grid_find_best(const struct wlr_box *bounds,
+		const struct wlr_box *rects, int nr_rects, int width, int height,
+		int *x, int *y)
+{
+	if (width > bounds->width || height > bounds->height
+			|| wlr_box_empty(bounds)) {
+		return false;
+	}
+
+	struct grid grid = {0};
+	build_grid(&grid, bounds, rects, nr_rects);
+
+	int nr_row_cells = grid.nr_rows - 1;
+	int nr_col_cells = grid.nr_cols - 1;
+	struct candidate *row_cands =
+		xzalloc(2 * nr_row_cells * sizeof(*row_cands));
+	struct candidate *col_cands =
+		xzalloc(2 * nr_col_cells * sizeof(*col_cands));
+	get_candidates(grid.rows, grid.nr_rows, height, row_cands);
+	get_candidates(grid.cols, grid.nr_cols, width, col_cands);
+
+	/* One strip each for the forward and backward row candidate */
+	struct strip strips[2];
+	for (int dir = 0; dir < 2; dir++) {
+		strips[dir].area = xzalloc(grid.nr_cols * sizeof(int64_t));
+		strips[dir].per_width = xzalloc(nr_col_cells * sizeof(int64_t));
+	}
+
+	int64_t min_overlap = INT64_MAX;
+	for (int i = 0; i < nr_row_cells && min_overlap > 0; i++) {
+		bool fits_row = height <= grid.rows[i + 1] - grid.rows[i];
+		for (int dir = 0; dir < 2; dir++) {
+			if (row_cands[2 * i + dir].valid) {
+				build_strip(&grid, &row_cands[2 * i + dir],
+					&strips[dir]);
+			}
+		}
+
+		for (int j = 0; j < nr_col_cells && min_overlap > 0; j++) {
+			bool fits_col = width <= grid.cols[j + 1] - grid.cols[j];
+			/*
+			 * A region larger than the cell can extend either
+			 * forward or backward on each axis, so all four
+			 * combinations need to be checked. If it fits within
+			 * the cell, the overlap is the same for all of them.
+			 */
+			int nr_dirs = fits_row && fits_col ? 1 : 4;
+			for (int dir = 0; dir < nr_dirs; dir++) {
+				struct candidate *col = &col_cands[2 * j + (dir & 1)];
+				struct candidate *row = &row_cands[2 * i + (dir >> 1)];
+				if (!col->valid || !row->valid) {
+					continue;
+				}
+				int64_t overlap = strip_get_overlap(
+					&strips[dir >> 1], col->pos);
+				if (overlap < min_overlap) {
+					min_overlap = overlap;
+					*x = col->start;
+					*y = row->start;
+				}
+			}
+		}
+	}
+
+	for (int dir = 0; dir < 2; dir++) {
+		free(strips[dir].area);
+		free(strips[dir].per_width);
+	}
+	free(row_cands);
+	free(col_cands);
+	destroy_grid(&grid);
+	return min_overlap != INT64_MAX;
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include "common/premultiply.h"
+
+/*
+ * Rounded division of a product of two 8-bit values by 255, done as
+ * (t + (t >> 8)) >> 8 with t = c * a + 128. This equals (c * a + 127) / 255
+ * for all 8-bit c and a, and every intermediate value fits in 16 bits.
+ */
+static inline uint32_t
+mul_div255(uint16_t c, uint16_t a)
+{
+	uint16_t t = c * a + 128;
+	return (uint16_t)(t + (t >> 8)) >> 8;
+}
+
+static inline uint32_t
+premultiply_pixel(uint32_t pixel)
+{
+	uint16_t alpha = pixel >> 24;
+	return (uint32_t)alpha << 24
+		| mul_div255((pixel >> 16) & 0xff, alpha) << 16
+		| mul_div255((pixel >> 8) & 0xff, alpha) << 8
+		| mul_div255(pixel & 0xff, alpha);
+}
+
+/* Pixels per iteration of the main loop */
+#define BLOCK_SIZE 8
+
+/*
+ * premultiply_pixel() has no branches or table lookups and only needs
+ * 16-bit multiplications. Processing fixed-size blocks lets compilers
+ * vectorize the main loop at -O2 already, using the baseline instruction
+ * set of all common architectures (e.g. SSE2 or NEON).
+ */
+void
+premultiply_argb32(uint32_t *restrict dst, const uint32_t *restrict src,
+		size_t nr_pixels)
+{
+	size_t i = 0;
+	for (; i + BLOCK_SIZE <= nr_pixels; i += BLOCK_SIZE) {
+		for (size_t j = 0; j < BLOCK_SIZE; j++) {
+			dst[i + j] = premultiply_pixel(src[i + j]);
+		}
+	}
+	for (; i < nr_pixels; i++) {
+		dst[i] = premultiply_pixel(src[i]);
+	}
+}
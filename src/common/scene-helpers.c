@@ -5,8 +5,11 @@
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/util/log.h>
+#include "common/time-helpers.h"
 #include "magnifier.h"
 #include "output.h"
+#include "output-stats.h"
+#include "render-delay.h"
 
 struct wlr_surface *
 lab_wlr_surface_from_node(struct wlr_scene_node *node)
@@ -77,16 +80,25 @@ lab_wlr_scene_output_commit(struct wlr_scene_output *scene_output,
 	bool wants_magnification = output_wants_magnification(output);
 
 	/*
-	 * FIXME: Regardless of wants_magnification, we are currently adding
-	 * damages to next frame when magnifier is shown, which forces
-	 * rendering on every output commit and overloads CPU.
-	 * We also need to verify the necessity of wants_magnification.
+	 * The magnifier only forces a frame if the cursor or magnification
+	 * changed, otherwise the magnified content is re-rendered only along
+	 * with damage from the scene.
 	 */
 	if (!wlr_scene_output_needs_frame(scene_output) && !wants_magnification) {
 		return true;
 	}
 
-	if (!wlr_scene_output_build_state(scene_output, state, NULL)) {
+	pixman_region32_t magnifier_damage;
+	pixman_region32_init(&magnifier_damage);
+	magnifier_add_damage(output, &magnifier_damage);
+	scene_output_damage(scene_output, &magnifier_damage);
+	pixman_region32_fini(&magnifier_damage);
+
+	uint64_t start = time_now_nsec();
+	struct wlr_scene_output_state_options options = {
+		.timer = output_stats_get_timer(output),
+	};
+	if (!wlr_scene_output_build_state(scene_output, state, &options)) {
 		wlr_log(WLR_ERROR, "Failed to build output state for %s",
 			wlr_output->name);
 		return false;
@@ -98,9 +110,8 @@ lab_wlr_scene_output_commit(struct wlr_scene_output *scene_output,
 		}
 	}
 
-	struct wlr_box additional_damage = {0};
 	if (state->buffer && magnifier_is_enabled()) {
-		magnifier_draw(output, state->buffer, &additional_damage);
+		magnifier_draw(output, state->buffer);
 	}
 
 	bool committed = wlr_output_commit_state(wlr_output, state);
@@ -113,6 +124,9 @@ lab_wlr_scene_output_commit(struct wlr_scene_output *scene_output,
 		committed = wlr_output_commit_state(wlr_output, state);
 	}
 	if (committed) {
+		uint64_t duration = time_now_nsec() - start;
+		output_stats_add_frame(output, state, duration);
+		render_delay_add_sample(output, duration);
 		if (state == &output->pending) {
 			wlr_output_state_finish(&output->pending);
 			wlr_output_state_init(&output->pending);
@@ -123,14 +137,5 @@ lab_wlr_scene_output_commit(struct wlr_scene_output *scene_output,
 		return false;
 	}
 
-	if (!wlr_box_empty(&additional_damage)) {
-		pixman_region32_t region;
-		pixman_region32_init_rect(&region,
-			additional_damage.x, additional_damage.y,
-			additional_damage.width, additional_damage.height);
-		scene_output_damage(scene_output, &region);
-		pixman_region32_fini(&region);
-	}
-
 	return true;
 }
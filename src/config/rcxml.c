@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/stat.h>
 #include <wlr/util/box.h>
 #include <wlr/util/log.h>
 #include "action.h"
@@ -16,6 +17,7 @@
 #include "common/dir.h"
 #include "common/list.h"
 #include "common/macros.h"
+#include "common/match.h"
 #include "common/mem.h"
 #include "common/nodename.h"
 #include "common/parse-bool.h"
@@ -33,6 +35,7 @@
 #include "labwc.h"
 #include "regions.h"
 #include "ssd.h"
+#include "startup-profile.h"
 #include "translate.h"
 #include "view.h"
 #include "window-rules.h"
@@ -228,6 +231,36 @@ fill_usable_area_override(xmlNode *node)
 	}
 }
 
+static void
+fill_render_delay(xmlNode *node)
+{
+	struct render_delay_config *config = znew(*config);
+	wl_list_append(&rc.render_delays, &config->link);
+
+	xmlNode *child;
+	char *key, *content;
+	LAB_XML_FOR_EACH(node, child, key, content) {
+		if (!strcmp(key, "output")) {
+			xstrdup_replace(config->output, content);
+		} else if (!strcasecmp(key, "maxRenderTime")) {
+			if (!strcasecmp(content, "off")) {
+				config->mode = LAB_RENDER_DELAY_OFF;
+			} else if (!strcasecmp(content, "auto")) {
+				config->mode = LAB_RENDER_DELAY_AUTO;
+			} else if (atoi(content) > 0) {
+				config->mode = LAB_RENDER_DELAY_FIXED;
+				config->max_render_time = atoi(content);
+			} else {
+				wlr_log(WLR_ERROR, "Invalid renderDelay "
+					"maxRenderTime '%s'", content);
+			}
+		} else {
+			wlr_log(WLR_ERROR, "Unexpected data renderDelay "
+				"parser: %s=\"%s\"", key, content);
+		}
+	}
+}
+
 /* Does a boolean-parse but also allows 'default' */
 static void
 set_property(const char *str, enum property *variable)
@@ -250,6 +283,7 @@ fill_window_rule(xmlNode *node)
 	window_rule->window_type = LAB_WINDOW_TYPE_INVALID;
 	wl_list_append(&rc.window_rules, &window_rule->link);
 	wl_list_init(&window_rule->actions);
+	enum property *props = window_rule->properties;
 
 	xmlNode *child;
 	char *key, *content;
@@ -280,30 +314,41 @@ fill_window_rule(xmlNode *node)
 
 		/* Properties */
 		} else if (!strcasecmp(key, "serverDecoration")) {
-			set_property(content, &window_rule->server_decoration);
+			set_property(content, &props[LAB_RULE_PROP_SERVER_DECORATION]);
 		} else if (!strcasecmp(key, "iconPriority")) {
 			if (!strcasecmp(content, "client")) {
-				window_rule->icon_prefer_client = LAB_PROP_TRUE;
+				props[LAB_RULE_PROP_ICON_PREFER_CLIENT] = LAB_PROP_TRUE;
 			} else if (!strcasecmp(content, "server")) {
-				window_rule->icon_prefer_client = LAB_PROP_FALSE;
+				props[LAB_RULE_PROP_ICON_PREFER_CLIENT] = LAB_PROP_FALSE;
 			} else {
 				wlr_log(WLR_ERROR,
 					"Invalid value for window rule property 'iconPriority'");
 			}
 		} else if (!strcasecmp(key, "skipTaskbar")) {
-			set_property(content, &window_rule->skip_taskbar);
+			set_property(content, &props[LAB_RULE_PROP_SKIP_TASKBAR]);
 		} else if (!strcasecmp(key, "skipWindowSwitcher")) {
-			set_property(content, &window_rule->skip_window_switcher);
+			set_property(content, &props[LAB_RULE_PROP_SKIP_WINDOW_SWITCHER]);
 		} else if (!strcasecmp(key, "ignoreFocusRequest")) {
-			set_property(content, &window_rule->ignore_focus_request);
+			set_property(content, &props[LAB_RULE_PROP_IGNORE_FOCUS_REQUEST]);
 		} else if (!strcasecmp(key, "ignoreConfigureRequest")) {
-			set_property(content, &window_rule->ignore_configure_request);
+			set_property(content, &props[LAB_RULE_PROP_IGNORE_CONFIGURE_REQUEST]);
 		} else if (!strcasecmp(key, "fixedPosition")) {
-			set_property(content, &window_rule->fixed_position);
+			set_property(content, &props[LAB_RULE_PROP_FIXED_POSITION]);
+		} else if (!strcasecmp(key, "renderDelay")) {
+			set_property(content, &props[LAB_RULE_PROP_RENDER_DELAY]);
 		}
 	}
 
 	append_parsed_actions(node, &window_rule->actions);
+
+	if (window_rule->identifier) {
+		match_pattern_compile(&window_rule->identifier_pattern,
+			window_rule->identifier);
+	}
+	if (window_rule->title) {
+		match_pattern_compile(&window_rule->title_pattern,
+			window_rule->title);
+	}
 }
 
 static void
@@ -455,36 +500,36 @@ parse_action_args(xmlNode *node, struct action *action)
 	LAB_XML_FOR_EACH(node, child, key, content) {
 		if (!strcasecmp(key, "query")) {
 			struct wl_list *querylist =
-				action_get_querylist(action, "query");
+				action_get_querylist(action, ACTION_ARG_QUERY);
 			if (!querylist) {
 				action_arg_add_querylist(action, "query");
-				querylist = action_get_querylist(action, "query");
+				querylist = action_get_querylist(action, ACTION_ARG_QUERY);
 			}
 			struct view_query *query = view_query_create();
 			fill_action_query(action, child, query);
 			wl_list_append(querylist, &query->link);
 		} else if (!strcasecmp(key, "then")) {
 			struct wl_list *actions =
-				action_get_actionlist(action, "then");
+				action_get_actionlist(action, ACTION_ARG_THEN);
 			if (!actions) {
 				action_arg_add_actionlist(action, "then");
-				actions = action_get_actionlist(action, "then");
+				actions = action_get_actionlist(action, ACTION_ARG_THEN);
 			}
 			append_parsed_actions(child, actions);
 		} else if (!strcasecmp(key, "else")) {
 			struct wl_list *actions =
-				action_get_actionlist(action, "else");
+				action_get_actionlist(action, ACTION_ARG_ELSE);
 			if (!actions) {
 				action_arg_add_actionlist(action, "else");
-				actions = action_get_actionlist(action, "else");
+				actions = action_get_actionlist(action, ACTION_ARG_ELSE);
 			}
 			append_parsed_actions(child, actions);
 		} else if (!strcasecmp(key, "none")) {
 			struct wl_list *actions =
-				action_get_actionlist(action, "none");
+				action_get_actionlist(action, ACTION_ARG_NONE);
 			if (!actions) {
 				action_arg_add_actionlist(action, "none");
-				actions = action_get_actionlist(action, "none");
+				actions = action_get_actionlist(action, ACTION_ARG_NONE);
 			}
 			append_parsed_actions(child, actions);
 		} else if (!strcasecmp(key, "name")) {
@@ -1030,175 +1075,505 @@ set_tearing_mode(const char *str, enum tearing_mode *variable)
 	}
 }
 
+/*
+ * Nodes handled by entry(), keyed by their path from the root node. The
+ * table is sorted on first use so that lookups can use bsearch().
+ */
+enum rc_node {
+	RC_NODE_UNKNOWN = 0,
+	RC_NODE_MARGIN,
+	RC_NODE_RENDER_DELAY,
+	RC_NODE_KEYBOARD_KEYBIND,
+	RC_NODE_MOUSE_CONTEXT,
+	RC_NODE_TOUCH,
+	RC_NODE_LIBINPUT_DEVICE,
+	RC_NODE_REGIONS,
+	RC_NODE_WINDOW_SWITCHER_FIELDS,
+	RC_NODE_WINDOW_RULES,
+	RC_NODE_THEME_FONT,
+	RC_NODE_TABLET_MAP,
+	RC_NODE_KEYBOARD_DEFAULT,
+	RC_NODE_MOUSE_DEFAULT,
+	RC_NODE_DESKTOPS_PREFIX,
+	RC_NODE_WINDOW_SWITCHER_OSD_THUMBNAIL_LABEL_FORMAT,
+	RC_NODE_CORE_DECORATION,
+	RC_NODE_CORE_GAP,
+	RC_NODE_CORE_ADAPTIVE_SYNC,
+	RC_NODE_CORE_ALLOW_TEARING,
+	RC_NODE_CORE_AUTO_ENABLE_OUTPUTS,
+	RC_NODE_CORE_REUSE_OUTPUT_MODE,
+	RC_NODE_CORE_XWAYLAND_PERSISTENCE,
+	RC_NODE_CORE_PRIMARY_SELECTION,
+	RC_NODE_CORE_PROMPT_COMMAND,
+	RC_NODE_PLACEMENT_POLICY,
+	RC_NODE_PLACEMENT_CASCADE_OFFSET_X,
+	RC_NODE_PLACEMENT_CASCADE_OFFSET_Y,
+	RC_NODE_THEME_NAME,
+	RC_NODE_THEME_ICON,
+	RC_NODE_THEME_FALLBACK_APP_ICON,
+	RC_NODE_THEME_TITLEBAR_LAYOUT,
+	RC_NODE_THEME_TITLEBAR_SHOW_TITLE,
+	RC_NODE_THEME_CORNERRADIUS,
+	RC_NODE_THEME_KEEP_BORDER,
+	RC_NODE_THEME_MAXIMIZED_DECORATION,
+	RC_NODE_THEME_DROP_SHADOWS,
+	RC_NODE_THEME_DROP_SHADOWS_ON_TILED,
+	RC_NODE_FOCUS_FOLLOW_MOUSE,
+	RC_NODE_FOCUS_FOLLOW_MOUSE_REQUIRES_MOVEMENT,
+	RC_NODE_FOCUS_RAISE_ON_FOCUS,
+	RC_NODE_MOUSE_DOUBLE_CLICK_TIME,
+	RC_NODE_MOUSE_SCROLL_FACTOR,
+	RC_NODE_KEYBOARD_REPEAT_RATE,
+	RC_NODE_KEYBOARD_REPEAT_DELAY,
+	RC_NODE_KEYBOARD_NUMLOCK,
+	RC_NODE_KEYBOARD_LAYOUT_SCOPE,
+	RC_NODE_RESISTANCE_SCREEN_EDGE_STRENGTH,
+	RC_NODE_RESISTANCE_WINDOW_EDGE_STRENGTH,
+	RC_NODE_RESISTANCE_UN_SNAP_THRESHOLD,
+	RC_NODE_RESISTANCE_UN_MAXIMIZE_THRESHOLD,
+	RC_NODE_SNAPPING_RANGE,
+	RC_NODE_SNAPPING_RANGE_INNER,
+	RC_NODE_SNAPPING_RANGE_OUTER,
+	RC_NODE_SNAPPING_CORNER_RANGE,
+	RC_NODE_SNAPPING_OVERLAY_ENABLED,
+	RC_NODE_SNAPPING_OVERLAY_DELAY_INNER,
+	RC_NODE_SNAPPING_OVERLAY_DELAY_OUTER,
+	RC_NODE_SNAPPING_TOP_MAXIMIZE,
+	RC_NODE_SNAPPING_NOTIFY_CLIENT,
+	RC_NODE_WINDOW_SWITCHER_OSD_SHOW,
+	RC_NODE_WINDOW_SWITCHER_OSD_STYLE,
+	RC_NODE_WINDOW_SWITCHER_OSD_OUTPUT,
+	RC_NODE_WINDOW_SWITCHER_OSD_LIVE,
+	RC_NODE_WINDOW_SWITCHER_OSD_LIVE_BUDGET,
+	RC_NODE_WINDOW_SWITCHER_ORDER,
+	RC_NODE_WINDOW_SWITCHER_SHOW,
+	RC_NODE_WINDOW_SWITCHER_STYLE,
+	RC_NODE_WINDOW_SWITCHER_PREVIEW,
+	RC_NODE_WINDOW_SWITCHER_OUTLINES,
+	RC_NODE_WINDOW_SWITCHER_ALL_WORKSPACES,
+	RC_NODE_WINDOW_SWITCHER_UNSHADE,
+	RC_NODE_CORE_CYCLE_VIEW_OSD,
+	RC_NODE_CORE_CYCLE_VIEW_PREVIEW,
+	RC_NODE_CORE_CYCLE_VIEW_OUTLINES,
+	RC_NODE_DESKTOPS_NAMES_NAME,
+	RC_NODE_DESKTOPS_POPUP_TIME,
+	RC_NODE_DESKTOPS_INITIAL,
+	RC_NODE_DESKTOPS_NUMBER,
+	RC_NODE_RESIZE_POPUP_SHOW,
+	RC_NODE_RESIZE_DRAW_CONTENTS,
+	RC_NODE_RESIZE_CORNER_RANGE,
+	RC_NODE_RESIZE_MINIMUM_AREA,
+	RC_NODE_TABLET_MOUSE_EMULATION,
+	RC_NODE_TABLET_MAP_TO_OUTPUT,
+	RC_NODE_TABLET_ROTATE,
+	RC_NODE_TABLET_AREA_LEFT,
+	RC_NODE_TABLET_AREA_TOP,
+	RC_NODE_TABLET_AREA_WIDTH,
+	RC_NODE_TABLET_AREA_HEIGHT,
+	RC_NODE_TABLET_TOOL_MOTION,
+	RC_NODE_TABLET_TOOL_RELATIVE_MOTION_SENSITIVITY,
+	RC_NODE_MENU_IGNORE_BUTTON_RELEASE_PERIOD,
+	RC_NODE_MENU_SHOW_ICONS,
+	RC_NODE_MAGNIFIER_WIDTH,
+	RC_NODE_MAGNIFIER_HEIGHT,
+	RC_NODE_MAGNIFIER_INIT_SCALE,
+	RC_NODE_MAGNIFIER_INCREMENT,
+	RC_NODE_MAGNIFIER_USE_FILTER,
+};
+
+static struct rc_node_name {
+	const char *name;
+	enum rc_node id;
+} rc_node_names[] = {
+	{ "margin", RC_NODE_MARGIN },
+	{ "renderDelay", RC_NODE_RENDER_DELAY },
+	{ "keybind.keyboard", RC_NODE_KEYBOARD_KEYBIND },
+	{ "context.mouse", RC_NODE_MOUSE_CONTEXT },
+	{ "touch", RC_NODE_TOUCH },
+	{ "device.libinput", RC_NODE_LIBINPUT_DEVICE },
+	{ "regions", RC_NODE_REGIONS },
+	{ "fields.windowSwitcher", RC_NODE_WINDOW_SWITCHER_FIELDS },
+	{ "windowRules", RC_NODE_WINDOW_RULES },
+	{ "font.theme", RC_NODE_THEME_FONT },
+	{ "map.tablet", RC_NODE_TABLET_MAP },
+	{ "default.keyboard", RC_NODE_KEYBOARD_DEFAULT },
+	{ "default.mouse", RC_NODE_MOUSE_DEFAULT },
+	{ "prefix.desktops", RC_NODE_DESKTOPS_PREFIX },
+	{ "thumbnailLabelFormat.osd.windowSwitcher", RC_NODE_WINDOW_SWITCHER_OSD_THUMBNAIL_LABEL_FORMAT },
+	{ "decoration.core", RC_NODE_CORE_DECORATION },
+	{ "gap.core", RC_NODE_CORE_GAP },
+	{ "adaptiveSync.core", RC_NODE_CORE_ADAPTIVE_SYNC },
+	{ "allowTearing.core", RC_NODE_CORE_ALLOW_TEARING },
+	{ "autoEnableOutputs.core", RC_NODE_CORE_AUTO_ENABLE_OUTPUTS },
+	{ "reuseOutputMode.core", RC_NODE_CORE_REUSE_OUTPUT_MODE },
+	{ "xwaylandPersistence.core", RC_NODE_CORE_XWAYLAND_PERSISTENCE },
+	{ "primarySelection.core", RC_NODE_CORE_PRIMARY_SELECTION },
+	{ "promptCommand.core", RC_NODE_CORE_PROMPT_COMMAND },
+	{ "policy.placement", RC_NODE_PLACEMENT_POLICY },
+	{ "x.cascadeOffset.placement", RC_NODE_PLACEMENT_CASCADE_OFFSET_X },
+	{ "y.cascadeOffset.placement", RC_NODE_PLACEMENT_CASCADE_OFFSET_Y },
+	{ "name.theme", RC_NODE_THEME_NAME },
+	{ "icon.theme", RC_NODE_THEME_ICON },
+	{ "fallbackAppIcon.theme", RC_NODE_THEME_FALLBACK_APP_ICON },
+	{ "layout.titlebar.theme", RC_NODE_THEME_TITLEBAR_LAYOUT },
+	{ "showTitle.titlebar.theme", RC_NODE_THEME_TITLEBAR_SHOW_TITLE },
+	{ "cornerradius.theme", RC_NODE_THEME_CORNERRADIUS },
+	{ "keepBorder.theme", RC_NODE_THEME_KEEP_BORDER },
+	{ "maximizedDecoration.theme", RC_NODE_THEME_MAXIMIZED_DECORATION },
+	{ "dropShadows.theme", RC_NODE_THEME_DROP_SHADOWS },
+	{ "dropShadowsOnTiled.theme", RC_NODE_THEME_DROP_SHADOWS_ON_TILED },
+	{ "followMouse.focus", RC_NODE_FOCUS_FOLLOW_MOUSE },
+	{ "followMouseRequiresMovement.focus", RC_NODE_FOCUS_FOLLOW_MOUSE_REQUIRES_MOVEMENT },
+	{ "raiseOnFocus.focus", RC_NODE_FOCUS_RAISE_ON_FOCUS },
+	{ "doubleClickTime.mouse", RC_NODE_MOUSE_DOUBLE_CLICK_TIME },
+	{ "scrollFactor.mouse", RC_NODE_MOUSE_SCROLL_FACTOR },
+	{ "repeatRate.keyboard", RC_NODE_KEYBOARD_REPEAT_RATE },
+	{ "repeatDelay.keyboard", RC_NODE_KEYBOARD_REPEAT_DELAY },
+	{ "numlock.keyboard", RC_NODE_KEYBOARD_NUMLOCK },
+	{ "layoutScope.keyboard", RC_NODE_KEYBOARD_LAYOUT_SCOPE },
+	{ "screenEdgeStrength.resistance", RC_NODE_RESISTANCE_SCREEN_EDGE_STRENGTH },
+	{ "windowEdgeStrength.resistance", RC_NODE_RESISTANCE_WINDOW_EDGE_STRENGTH },
+	{ "unSnapThreshold.resistance", RC_NODE_RESISTANCE_UN_SNAP_THRESHOLD },
+	{ "unMaximizeThreshold.resistance", RC_NODE_RESISTANCE_UN_MAXIMIZE_THRESHOLD },
+	{ "range.snapping", RC_NODE_SNAPPING_RANGE },
+	{ "inner.range.snapping", RC_NODE_SNAPPING_RANGE_INNER },
+	{ "outer.range.snapping", RC_NODE_SNAPPING_RANGE_OUTER },
+	{ "cornerRange.snapping", RC_NODE_SNAPPING_CORNER_RANGE },
+	{ "enabled.overlay.snapping", RC_NODE_SNAPPING_OVERLAY_ENABLED },
+	{ "inner.delay.overlay.snapping", RC_NODE_SNAPPING_OVERLAY_DELAY_INNER },
+	{ "outer.delay.overlay.snapping", RC_NODE_SNAPPING_OVERLAY_DELAY_OUTER },
+	{ "topMaximize.snapping", RC_NODE_SNAPPING_TOP_MAXIMIZE },
+	{ "notifyClient.snapping", RC_NODE_SNAPPING_NOTIFY_CLIENT },
+	{ "show.osd.windowSwitcher", RC_NODE_WINDOW_SWITCHER_OSD_SHOW },
+	{ "style.osd.windowSwitcher", RC_NODE_WINDOW_SWITCHER_OSD_STYLE },
+	{ "output.osd.windowSwitcher", RC_NODE_WINDOW_SWITCHER_OSD_OUTPUT },
+	{ "live.osd.windowSwitcher", RC_NODE_WINDOW_SWITCHER_OSD_LIVE },
+	{ "liveBudget.osd.windowSwitcher", RC_NODE_WINDOW_SWITCHER_OSD_LIVE_BUDGET },
+	{ "order.windowSwitcher", RC_NODE_WINDOW_SWITCHER_ORDER },
+	{ "show.windowSwitcher", RC_NODE_WINDOW_SWITCHER_SHOW },
+	{ "style.windowSwitcher", RC_NODE_WINDOW_SWITCHER_STYLE },
+	{ "preview.windowSwitcher", RC_NODE_WINDOW_SWITCHER_PREVIEW },
+	{ "outlines.windowSwitcher", RC_NODE_WINDOW_SWITCHER_OUTLINES },
+	{ "allWorkspaces.windowSwitcher", RC_NODE_WINDOW_SWITCHER_ALL_WORKSPACES },
+	{ "unshade.windowSwitcher", RC_NODE_WINDOW_SWITCHER_UNSHADE },
+	{ "cycleViewOSD.core", RC_NODE_CORE_CYCLE_VIEW_OSD },
+	{ "cycleViewPreview.core", RC_NODE_CORE_CYCLE_VIEW_PREVIEW },
+	{ "cycleViewOutlines.core", RC_NODE_CORE_CYCLE_VIEW_OUTLINES },
+	{ "name.names.desktops", RC_NODE_DESKTOPS_NAMES_NAME },
+	{ "popupTime.desktops", RC_NODE_DESKTOPS_POPUP_TIME },
+	{ "initial.desktops", RC_NODE_DESKTOPS_INITIAL },
+	{ "number.desktops", RC_NODE_DESKTOPS_NUMBER },
+	{ "popupShow.resize", RC_NODE_RESIZE_POPUP_SHOW },
+	{ "drawContents.resize", RC_NODE_RESIZE_DRAW_CONTENTS },
+	{ "cornerRange.resize", RC_NODE_RESIZE_CORNER_RANGE },
+	{ "minimumArea.resize", RC_NODE_RESIZE_MINIMUM_AREA },
+	{ "mouseEmulation.tablet", RC_NODE_TABLET_MOUSE_EMULATION },
+	{ "mapToOutput.tablet", RC_NODE_TABLET_MAP_TO_OUTPUT },
+	{ "rotate.tablet", RC_NODE_TABLET_ROTATE },
+	{ "left.area.tablet", RC_NODE_TABLET_AREA_LEFT },
+	{ "top.area.tablet", RC_NODE_TABLET_AREA_TOP },
+	{ "width.area.tablet", RC_NODE_TABLET_AREA_WIDTH },
+	{ "height.area.tablet", RC_NODE_TABLET_AREA_HEIGHT },
+	{ "motion.tabletTool", RC_NODE_TABLET_TOOL_MOTION },
+	{ "relativeMotionSensitivity.tabletTool", RC_NODE_TABLET_TOOL_RELATIVE_MOTION_SENSITIVITY },
+	{ "ignoreButtonReleasePeriod.menu", RC_NODE_MENU_IGNORE_BUTTON_RELEASE_PERIOD },
+	{ "showIcons.menu", RC_NODE_MENU_SHOW_ICONS },
+	{ "width.magnifier", RC_NODE_MAGNIFIER_WIDTH },
+	{ "height.magnifier", RC_NODE_MAGNIFIER_HEIGHT },
+	{ "initScale.magnifier", RC_NODE_MAGNIFIER_INIT_SCALE },
+	{ "increment.magnifier", RC_NODE_MAGNIFIER_INCREMENT },
+	{ "useFilter.magnifier", RC_NODE_MAGNIFIER_USE_FILTER },
+};
+
+/* Set from LABWC_DEBUG_CONFIG_NODENAMES for each parse */
+static bool debug_nodenames;
+
+static int
+compare_node_names(const void *a, const void *b)
+{
+	const struct rc_node_name *na = a;
+	const struct rc_node_name *nb = b;
+	return strcasecmp(na->name, nb->name);
+}
+
+static void
+sort_node_names(void)
+{
+	static bool sorted;
+	if (!sorted) {
+		qsort(rc_node_names, ARRAY_SIZE(rc_node_names),
+			sizeof(rc_node_names[0]), compare_node_names);
+		sorted = true;
+	}
+}
+
+static enum rc_node
+lookup_node(const char *nodename)
+{
+	struct rc_node_name key = { .name = nodename };
+	struct rc_node_name *found = bsearch(&key, rc_node_names,
+		ARRAY_SIZE(rc_node_names), sizeof(rc_node_names[0]),
+		compare_node_names);
+	return found ? found->id : RC_NODE_UNKNOWN;
+}
+
+/* Removes the root node, e.g. "gap.core.openbox_config" -> "gap.core" */
+static void
+strip_root_nodename(char *nodename)
+{
+	char *dot = strrchr(nodename, '.');
+	if (dot && (!strcmp(dot, ".openbox_config")
+			|| !strcmp(dot, ".labwc_config"))) {
+		*dot = '\0';
+	}
+}
+
 /* Returns true if the node's children should also be traversed */
 static bool
 entry(xmlNode *node, char *nodename, char *content)
 {
-	string_truncate_at_pattern(nodename, ".openbox_config");
-	string_truncate_at_pattern(nodename, ".labwc_config");
+	strip_root_nodename(nodename);
 
-	if (getenv("LABWC_DEBUG_CONFIG_NODENAMES")) {
+	if (debug_nodenames) {
 		printf("%s: %s\n", nodename, content);
 	}
 
+	enum rc_node id = lookup_node(nodename);
+
+	switch (id) {
 	/* handle nested nodes */
-	if (!strcasecmp(nodename, "margin")) {
+	case RC_NODE_MARGIN:
 		fill_usable_area_override(node);
-	} else if (!strcasecmp(nodename, "keybind.keyboard")) {
+		return false;
+	case RC_NODE_RENDER_DELAY:
+		fill_render_delay(node);
+		return false;
+	case RC_NODE_KEYBOARD_KEYBIND:
 		fill_keybind(node);
-	} else if (!strcasecmp(nodename, "context.mouse")) {
+		return false;
+	case RC_NODE_MOUSE_CONTEXT:
 		fill_mouse_context(node);
-	} else if (!strcasecmp(nodename, "touch")) {
+		return false;
+	case RC_NODE_TOUCH:
 		fill_touch(node);
-	} else if (!strcasecmp(nodename, "device.libinput")) {
+		return false;
+	case RC_NODE_LIBINPUT_DEVICE:
 		fill_libinput_category(node);
-	} else if (!strcasecmp(nodename, "regions")) {
+		return false;
+	case RC_NODE_REGIONS:
 		fill_regions(node);
-	} else if (!strcasecmp(nodename, "fields.windowSwitcher")) {
+		return false;
+	case RC_NODE_WINDOW_SWITCHER_FIELDS:
 		fill_window_switcher_fields(node);
-	} else if (!strcasecmp(nodename, "windowRules")) {
+		return false;
+	case RC_NODE_WINDOW_RULES:
 		fill_window_rules(node);
-	} else if (!strcasecmp(nodename, "font.theme")) {
+		return false;
+	case RC_NODE_THEME_FONT:
 		fill_font(node);
-	} else if (!strcasecmp(nodename, "map.tablet")) {
+		return false;
+	case RC_NODE_TABLET_MAP:
 		fill_tablet_button_map(node);
+		return false;
 
 	/* handle nodes without content, e.g. <keyboard><default /> */
-	} else if (!strcmp(nodename, "default.keyboard")) {
+	case RC_NODE_KEYBOARD_DEFAULT:
 		load_default_key_bindings();
-	} else if (!strcmp(nodename, "default.mouse")) {
+		return false;
+	case RC_NODE_MOUSE_DEFAULT:
 		load_default_mouse_bindings();
-	} else if (!strcasecmp(nodename, "prefix.desktops")) {
+		return false;
+	case RC_NODE_DESKTOPS_PREFIX:
 		xstrdup_replace(rc.workspace_config.prefix, content);
-	} else if (!strcasecmp(nodename, "thumbnailLabelFormat.osd.windowSwitcher")) {
+		return false;
+	case RC_NODE_WINDOW_SWITCHER_OSD_THUMBNAIL_LABEL_FORMAT:
 		xstrdup_replace(rc.window_switcher.osd.thumbnail_label_format, content);
+		return false;
+	default:
+		break;
+	}
 
-	} else if (!lab_xml_node_is_leaf(node)) {
+	if (!lab_xml_node_is_leaf(node)) {
 		/* parse children of nested nodes other than above */
 		return true;
-
-	} else if (str_space_only(content)) {
+	}
+	if (str_space_only(content)) {
 		wlr_log(WLR_ERROR, "Empty string is not allowed for %s. "
 			"Ignoring.", nodename);
+		return false;
+	}
 
+	/* Remove this long term - just a friendly warning for now */
+	if (strstr(nodename, "windowswitcher.core")) {
+		wlr_log(WLR_ERROR, "<windowSwitcher> should not be child of <core>");
+		return false;
+	}
+
+	switch (id) {
 	/* handle non-empty leaf nodes */
-	} else if (!strcmp(nodename, "decoration.core")) {
+	case RC_NODE_CORE_DECORATION:
 		if (!strcmp(content, "client")) {
 			rc.xdg_shell_server_side_deco = false;
 		} else {
 			rc.xdg_shell_server_side_deco = true;
 		}
-	} else if (!strcmp(nodename, "gap.core")) {
+		break;
+	case RC_NODE_CORE_GAP:
 		rc.gap = atoi(content);
-	} else if (!strcasecmp(nodename, "adaptiveSync.core")) {
+		break;
+	case RC_NODE_CORE_ADAPTIVE_SYNC:
 		set_adaptive_sync_mode(content, &rc.adaptive_sync);
-	} else if (!strcasecmp(nodename, "allowTearing.core")) {
+		break;
+	case RC_NODE_CORE_ALLOW_TEARING:
 		set_tearing_mode(content, &rc.allow_tearing);
-	} else if (!strcasecmp(nodename, "autoEnableOutputs.core")) {
+		break;
+	case RC_NODE_CORE_AUTO_ENABLE_OUTPUTS:
 		set_bool(content, &rc.auto_enable_outputs);
-	} else if (!strcasecmp(nodename, "reuseOutputMode.core")) {
+		break;
+	case RC_NODE_CORE_REUSE_OUTPUT_MODE:
 		set_bool(content, &rc.reuse_output_mode);
-	} else if (!strcasecmp(nodename, "xwaylandPersistence.core")) {
+		break;
+	case RC_NODE_CORE_XWAYLAND_PERSISTENCE:
 		set_bool(content, &rc.xwayland_persistence);
-	} else if (!strcasecmp(nodename, "primarySelection.core")) {
+		break;
+	case RC_NODE_CORE_PRIMARY_SELECTION:
 		set_bool(content, &rc.primary_selection);
+		break;
 
-	} else if (!strcasecmp(nodename, "promptCommand.core")) {
+	case RC_NODE_CORE_PROMPT_COMMAND:
 		xstrdup_replace(rc.prompt_command, content);
+		break;
 
-	} else if (!strcmp(nodename, "policy.placement")) {
+	case RC_NODE_PLACEMENT_POLICY: {
 		enum lab_placement_policy policy = view_placement_parse(content);
 		if (policy != LAB_PLACE_INVALID) {
 			rc.placement_policy = policy;
 		}
-	} else if (!strcasecmp(nodename, "x.cascadeOffset.placement")) {
+		break;
+	}
+	case RC_NODE_PLACEMENT_CASCADE_OFFSET_X:
 		rc.placement_cascade_offset_x = atoi(content);
-	} else if (!strcasecmp(nodename, "y.cascadeOffset.placement")) {
+		break;
+	case RC_NODE_PLACEMENT_CASCADE_OFFSET_Y:
 		rc.placement_cascade_offset_y = atoi(content);
-	} else if (!strcmp(nodename, "name.theme")) {
+		break;
+	case RC_NODE_THEME_NAME:
 		xstrdup_replace(rc.theme_name, content);
-	} else if (!strcmp(nodename, "icon.theme")) {
+		break;
+	case RC_NODE_THEME_ICON:
 		xstrdup_replace(rc.icon_theme_name, content);
-	} else if (!strcasecmp(nodename, "fallbackAppIcon.theme")) {
+		break;
+	case RC_NODE_THEME_FALLBACK_APP_ICON:
 		xstrdup_replace(rc.fallback_app_icon_name, content);
-	} else if (!strcasecmp(nodename, "layout.titlebar.theme")) {
+		break;
+	case RC_NODE_THEME_TITLEBAR_LAYOUT:
 		fill_title_layout(content);
-	} else if (!strcasecmp(nodename, "showTitle.titlebar.theme")) {
+		break;
+	case RC_NODE_THEME_TITLEBAR_SHOW_TITLE:
 		rc.show_title = parse_bool(content, true);
-	} else if (!strcmp(nodename, "cornerradius.theme")) {
+		break;
+	case RC_NODE_THEME_CORNERRADIUS:
 		rc.corner_radius = atoi(content);
-	} else if (!strcasecmp(nodename, "keepBorder.theme")) {
+		break;
+	case RC_NODE_THEME_KEEP_BORDER:
 		set_bool(content, &rc.ssd_keep_border);
-	} else if (!strcasecmp(nodename, "maximizedDecoration.theme")) {
+		break;
+	case RC_NODE_THEME_MAXIMIZED_DECORATION:
 		if (!strcasecmp(content, "titlebar")) {
 			rc.hide_maximized_window_titlebar = false;
 		} else if (!strcasecmp(content, "none")) {
 			rc.hide_maximized_window_titlebar = true;
 		}
-	} else if (!strcasecmp(nodename, "dropShadows.theme")) {
+		break;
+	case RC_NODE_THEME_DROP_SHADOWS:
 		set_bool(content, &rc.shadows_enabled);
-	} else if (!strcasecmp(nodename, "dropShadowsOnTiled.theme")) {
+		break;
+	case RC_NODE_THEME_DROP_SHADOWS_ON_TILED:
 		set_bool(content, &rc.shadows_on_tiled);
-	} else if (!strcasecmp(nodename, "followMouse.focus")) {
+		break;
+	case RC_NODE_FOCUS_FOLLOW_MOUSE:
 		set_bool(content, &rc.focus_follow_mouse);
-	} else if (!strcasecmp(nodename, "followMouseRequiresMovement.focus")) {
+		break;
+	case RC_NODE_FOCUS_FOLLOW_MOUSE_REQUIRES_MOVEMENT:
 		set_bool(content, &rc.focus_follow_mouse_requires_movement);
-	} else if (!strcasecmp(nodename, "raiseOnFocus.focus")) {
+		break;
+	case RC_NODE_FOCUS_RAISE_ON_FOCUS:
 		set_bool(content, &rc.raise_on_focus);
-	} else if (!strcasecmp(nodename, "doubleClickTime.mouse")) {
+		break;
+	case RC_NODE_MOUSE_DOUBLE_CLICK_TIME: {
 		long doubleclick_time_parsed = strtol(content, NULL, 10);
 		if (doubleclick_time_parsed > 0) {
 			rc.doubleclick_time = doubleclick_time_parsed;
 		} else {
 			wlr_log(WLR_ERROR, "invalid doubleClickTime");
 		}
-	} else if (!strcasecmp(nodename, "scrollFactor.mouse")) {
+		break;
+	}
+	case RC_NODE_MOUSE_SCROLL_FACTOR:
 		/* This is deprecated. Show an error message in post_processing() */
 		set_double(content, &mouse_scroll_factor);
+		break;
 
-	} else if (!strcasecmp(nodename, "repeatRate.keyboard")) {
+	case RC_NODE_KEYBOARD_REPEAT_RATE:
 		rc.repeat_rate = atoi(content);
-	} else if (!strcasecmp(nodename, "repeatDelay.keyboard")) {
+		break;
+	case RC_NODE_KEYBOARD_REPEAT_DELAY:
 		rc.repeat_delay = atoi(content);
-	} else if (!strcasecmp(nodename, "numlock.keyboard")) {
+		break;
+	case RC_NODE_KEYBOARD_NUMLOCK: {
 		bool value;
 		set_bool(content, &value);
 		rc.kb_numlock_enable = value ? LAB_STATE_ENABLED
 			: LAB_STATE_DISABLED;
-	} else if (!strcasecmp(nodename, "layoutScope.keyboard")) {
+		break;
+	}
+	case RC_NODE_KEYBOARD_LAYOUT_SCOPE:
 		/*
 		 * This can be changed to an enum later on
 		 * if we decide to also support "application".
 		 */
 		rc.kb_layout_per_window = !strcasecmp(content, "window");
-	} else if (!strcasecmp(nodename, "screenEdgeStrength.resistance")) {
+		break;
+	case RC_NODE_RESISTANCE_SCREEN_EDGE_STRENGTH:
 		rc.screen_edge_strength = atoi(content);
-	} else if (!strcasecmp(nodename, "windowEdgeStrength.resistance")) {
+		break;
+	case RC_NODE_RESISTANCE_WINDOW_EDGE_STRENGTH:
 		rc.window_edge_strength = atoi(content);
-	} else if (!strcasecmp(nodename, "unSnapThreshold.resistance")) {
+		break;
+	case RC_NODE_RESISTANCE_UN_SNAP_THRESHOLD:
 		rc.unsnap_threshold = atoi(content);
-	} else if (!strcasecmp(nodename, "unMaximizeThreshold.resistance")) {
+		break;
+	case RC_NODE_RESISTANCE_UN_MAXIMIZE_THRESHOLD:
 		rc.unmaximize_threshold = atoi(content);
-	} else if (!strcasecmp(nodename, "range.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_RANGE:
 		rc.snap_edge_range_inner = atoi(content);
 		rc.snap_edge_range_outer = atoi(content);
 		wlr_log(WLR_ERROR, "<snapping><range> is deprecated. "
 			"Use <snapping><range inner=\"\" outer=\"\"> instead.");
-	} else if (!strcasecmp(nodename, "inner.range.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_RANGE_INNER:
 		rc.snap_edge_range_inner = atoi(content);
-	} else if (!strcasecmp(nodename, "outer.range.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_RANGE_OUTER:
 		rc.snap_edge_range_outer = atoi(content);
-	} else if (!strcasecmp(nodename, "cornerRange.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_CORNER_RANGE:
 		rc.snap_edge_corner_range = atoi(content);
-	} else if (!strcasecmp(nodename, "enabled.overlay.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_OVERLAY_ENABLED:
 		set_bool(content, &rc.snap_overlay_enabled);
-	} else if (!strcasecmp(nodename, "inner.delay.overlay.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_OVERLAY_DELAY_INNER:
 		rc.snap_overlay_delay_inner = atoi(content);
-	} else if (!strcasecmp(nodename, "outer.delay.overlay.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_OVERLAY_DELAY_OUTER:
 		rc.snap_overlay_delay_outer = atoi(content);
-	} else if (!strcasecmp(nodename, "topMaximize.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_TOP_MAXIMIZE:
 		set_bool(content, &rc.snap_top_maximize);
-	} else if (!strcasecmp(nodename, "notifyClient.snapping")) {
+		break;
+	case RC_NODE_SNAPPING_NOTIFY_CLIENT:
 		if (!strcasecmp(content, "always")) {
 			rc.snap_tiling_events_mode = LAB_TILING_EVENTS_ALWAYS;
 		} else if (!strcasecmp(content, "region")) {
@@ -1210,17 +1585,20 @@ entry(xmlNode *node, char *nodename, char *content)
 		} else {
 			wlr_log(WLR_ERROR, "ignoring invalid value for notifyClient");
 		}
+		break;
 
 	/*
 	 * <windowSwitcher preview="" outlines="">
-	 *   <osd show="" style="" output="" thumbnailLabelFormat="" />
+	 *   <osd show="" style="" output="" thumbnailLabelFormat=""
+	 *     live="" liveBudget="" />
 	 * </windowSwitcher>
 	 *
 	 * thumnailLabelFormat is handled above to allow for an empty value
 	 */
-	} else if (!strcasecmp(nodename, "show.osd.windowSwitcher")) {
+	case RC_NODE_WINDOW_SWITCHER_OSD_SHOW:
 		set_bool(content, &rc.window_switcher.osd.show);
-	} else if (!strcasecmp(nodename, "style.osd.windowSwitcher")) {
+		break;
+	case RC_NODE_WINDOW_SWITCHER_OSD_STYLE:
 		if (!strcasecmp(content, "classic")) {
 			rc.window_switcher.osd.style = CYCLE_OSD_STYLE_CLASSIC;
 		} else if (!strcasecmp(content, "thumbnail")) {
@@ -1229,7 +1607,8 @@ entry(xmlNode *node, char *nodename, char *content)
 			wlr_log(WLR_ERROR, "Invalid windowSwitcher style '%s': "
 				"should be one of classic|thumbnail", content);
 		}
-	} else if (!strcasecmp(nodename, "output.osd.windowSwitcher")) {
+		break;
+	case RC_NODE_WINDOW_SWITCHER_OSD_OUTPUT:
 		if (!strcasecmp(content, "all")) {
 			rc.window_switcher.osd.output_filter = CYCLE_OUTPUT_ALL;
 		} else if (!strcasecmp(content, "cursor")) {
@@ -1240,7 +1619,16 @@ entry(xmlNode *node, char *nodename, char *content)
 			wlr_log(WLR_ERROR, "Invalid windowSwitcher output '%s': "
 				"should be one of all|focused|cursor", content);
 		}
-	} else if (!strcasecmp(nodename, "order.windowSwitcher")) {
+		break;
+	case RC_NODE_WINDOW_SWITCHER_OSD_LIVE:
+		set_bool(content, &rc.window_switcher.osd.live);
+		break;
+	case RC_NODE_WINDOW_SWITCHER_OSD_LIVE_BUDGET:
+		set_float(content, &rc.window_switcher.osd.live_budget);
+		rc.window_switcher.osd.live_budget =
+			MAX(0, rc.window_switcher.osd.live_budget);
+		break;
+	case RC_NODE_WINDOW_SWITCHER_ORDER:
 		if (!strcasecmp(content, "focus")) {
 			rc.window_switcher.order = WINDOW_SWITCHER_ORDER_FOCUS;
 		} else if (!strcasecmp(content, "age")) {
@@ -1249,13 +1637,15 @@ entry(xmlNode *node, char *nodename, char *content)
 			wlr_log(WLR_ERROR, "Invalid windowSwitcher order '%s': "
 				"should be one of focus|age", content);
 		}
+		break;
 
 	/* The following two are for backward compatibility only. */
-	} else if (!strcasecmp(nodename, "show.windowSwitcher")) {
+	case RC_NODE_WINDOW_SWITCHER_SHOW:
 		set_bool(content, &rc.window_switcher.osd.show);
 		wlr_log(WLR_ERROR, "<windowSwitcher show=\"\" /> is deprecated."
 			" Use <windowSwitcher><osd show=\"\" />");
-	} else if (!strcasecmp(nodename, "style.windowSwitcher")) {
+		break;
+	case RC_NODE_WINDOW_SWITCHER_STYLE:
 		if (!strcasecmp(content, "classic")) {
 			rc.window_switcher.osd.style = CYCLE_OSD_STYLE_CLASSIC;
 		} else if (!strcasecmp(content, "thumbnail")) {
@@ -1263,12 +1653,15 @@ entry(xmlNode *node, char *nodename, char *content)
 		}
 		wlr_log(WLR_ERROR, "<windowSwitcher style=\"\" /> is deprecated."
 			" Use <windowSwitcher><osd style=\"\" />");
+		break;
 
-	} else if (!strcasecmp(nodename, "preview.windowSwitcher")) {
+	case RC_NODE_WINDOW_SWITCHER_PREVIEW:
 		set_bool(content, &rc.window_switcher.preview);
-	} else if (!strcasecmp(nodename, "outlines.windowSwitcher")) {
+		break;
+	case RC_NODE_WINDOW_SWITCHER_OUTLINES:
 		set_bool(content, &rc.window_switcher.outlines);
-	} else if (!strcasecmp(nodename, "allWorkspaces.windowSwitcher")) {
+		break;
+	case RC_NODE_WINDOW_SWITCHER_ALL_WORKSPACES: {
 		int ret = parse_bool(content, -1);
 		if (ret < 0) {
 			wlr_log(WLR_ERROR, "Invalid value for <windowSwitcher"
@@ -1279,46 +1672,45 @@ entry(xmlNode *node, char *nodename, char *content)
 		}
 		wlr_log(WLR_ERROR, "<windowSwitcher allWorkspaces=\"\" /> is deprecated."
 			" Use <action name=\"NextWindow\" workspace=\"\"> instead.");
-	} else if (!strcasecmp(nodename, "unshade.windowSwitcher")) {
+		break;
+	}
+	case RC_NODE_WINDOW_SWITCHER_UNSHADE:
 		set_bool(content, &rc.window_switcher.unshade);
-
-	/* Remove this long term - just a friendly warning for now */
-	} else if (strstr(nodename, "windowswitcher.core")) {
-		wlr_log(WLR_ERROR, "<windowSwitcher> should not be child of <core>");
+		break;
 
 	/* The following three are for backward compatibility only */
-	} else if (!strcasecmp(nodename, "show.windowSwitcher.core")) {
-		set_bool(content, &rc.window_switcher.osd.show);
-	} else if (!strcasecmp(nodename, "preview.windowSwitcher.core")) {
-		set_bool(content, &rc.window_switcher.preview);
-	} else if (!strcasecmp(nodename, "outlines.windowSwitcher.core")) {
-		set_bool(content, &rc.window_switcher.outlines);
-
-	/* The following three are for backward compatibility only */
-	} else if (!strcasecmp(nodename, "cycleViewOSD.core")) {
+	case RC_NODE_CORE_CYCLE_VIEW_OSD:
 		set_bool(content, &rc.window_switcher.osd.show);
 		wlr_log(WLR_ERROR, "<cycleViewOSD> is deprecated."
 			" Use <windowSwitcher show=\"\" />");
-	} else if (!strcasecmp(nodename, "cycleViewPreview.core")) {
+		break;
+	case RC_NODE_CORE_CYCLE_VIEW_PREVIEW:
 		set_bool(content, &rc.window_switcher.preview);
 		wlr_log(WLR_ERROR, "<cycleViewPreview> is deprecated."
 			" Use <windowSwitcher preview=\"\" />");
-	} else if (!strcasecmp(nodename, "cycleViewOutlines.core")) {
+		break;
+	case RC_NODE_CORE_CYCLE_VIEW_OUTLINES:
 		set_bool(content, &rc.window_switcher.outlines);
 		wlr_log(WLR_ERROR, "<cycleViewOutlines> is deprecated."
 			" Use <windowSwitcher outlines=\"\" />");
+		break;
 
-	} else if (!strcasecmp(nodename, "name.names.desktops")) {
+	case RC_NODE_DESKTOPS_NAMES_NAME: {
 		struct workspace_config *conf = znew(*conf);
 		conf->name = xstrdup(content);
 		wl_list_append(&rc.workspace_config.workspaces, &conf->link);
-	} else if (!strcasecmp(nodename, "popupTime.desktops")) {
+		break;
+	}
+	case RC_NODE_DESKTOPS_POPUP_TIME:
 		rc.workspace_config.popuptime = atoi(content);
-	} else if (!strcasecmp(nodename, "initial.desktops")) {
+		break;
+	case RC_NODE_DESKTOPS_INITIAL:
 		xstrdup_replace(rc.workspace_config.initial_workspace_name, content);
-	} else if (!strcasecmp(nodename, "number.desktops")) {
+		break;
+	case RC_NODE_DESKTOPS_NUMBER:
 		rc.workspace_config.min_nr_workspaces = MAX(1, atoi(content));
-	} else if (!strcasecmp(nodename, "popupShow.resize")) {
+		break;
+	case RC_NODE_RESIZE_POPUP_SHOW:
 		if (!strcasecmp(content, "Always")) {
 			rc.resize_indicator = LAB_RESIZE_INDICATOR_ALWAYS;
 		} else if (!strcasecmp(content, "Never")) {
@@ -1328,52 +1720,96 @@ entry(xmlNode *node, char *nodename, char *content)
 		} else {
 			wlr_log(WLR_ERROR, "Invalid value for <resize popupShow />");
 		}
-	} else if (!strcasecmp(nodename, "drawContents.resize")) {
+		break;
+	case RC_NODE_RESIZE_DRAW_CONTENTS:
 		set_bool(content, &rc.resize_draw_contents);
-	} else if (!strcasecmp(nodename, "cornerRange.resize")) {
+		break;
+	case RC_NODE_RESIZE_CORNER_RANGE:
 		rc.resize_corner_range = atoi(content);
-	} else if (!strcasecmp(nodename, "minimumArea.resize")) {
+		break;
+	case RC_NODE_RESIZE_MINIMUM_AREA:
 		rc.resize_minimum_area = MAX(0, atoi(content));
-	} else if (!strcasecmp(nodename, "mouseEmulation.tablet")) {
+		break;
+	case RC_NODE_TABLET_MOUSE_EMULATION:
 		set_bool(content, &rc.tablet.force_mouse_emulation);
-	} else if (!strcasecmp(nodename, "mapToOutput.tablet")) {
+		break;
+	case RC_NODE_TABLET_MAP_TO_OUTPUT:
 		xstrdup_replace(rc.tablet.output_name, content);
-	} else if (!strcasecmp(nodename, "rotate.tablet")) {
+		break;
+	case RC_NODE_TABLET_ROTATE:
 		rc.tablet.rotation = tablet_parse_rotation(atoi(content));
-	} else if (!strcasecmp(nodename, "left.area.tablet")) {
+		break;
+	case RC_NODE_TABLET_AREA_LEFT:
 		rc.tablet.box.x = tablet_get_dbl_if_positive(content, "left");
-	} else if (!strcasecmp(nodename, "top.area.tablet")) {
+		break;
+	case RC_NODE_TABLET_AREA_TOP:
 		rc.tablet.box.y = tablet_get_dbl_if_positive(content, "top");
-	} else if (!strcasecmp(nodename, "width.area.tablet")) {
+		break;
+	case RC_NODE_TABLET_AREA_WIDTH:
 		rc.tablet.box.width = tablet_get_dbl_if_positive(content, "width");
-	} else if (!strcasecmp(nodename, "height.area.tablet")) {
+		break;
+	case RC_NODE_TABLET_AREA_HEIGHT:
 		rc.tablet.box.height = tablet_get_dbl_if_positive(content, "height");
-	} else if (!strcasecmp(nodename, "motion.tabletTool")) {
+		break;
+	case RC_NODE_TABLET_TOOL_MOTION:
 		rc.tablet_tool.motion = tablet_parse_motion(content);
-	} else if (!strcasecmp(nodename, "relativeMotionSensitivity.tabletTool")) {
+		break;
+	case RC_NODE_TABLET_TOOL_RELATIVE_MOTION_SENSITIVITY:
 		rc.tablet_tool.relative_motion_sensitivity =
 			tablet_get_dbl_if_positive(content, "relativeMotionSensitivity");
-	} else if (!strcasecmp(nodename, "ignoreButtonReleasePeriod.menu")) {
+		break;
+	case RC_NODE_MENU_IGNORE_BUTTON_RELEASE_PERIOD:
 		rc.menu_ignore_button_release_period = atoi(content);
-	} else if (!strcasecmp(nodename, "showIcons.menu")) {
+		break;
+	case RC_NODE_MENU_SHOW_ICONS:
 		set_bool(content, &rc.menu_show_icons);
-	} else if (!strcasecmp(nodename, "width.magnifier")) {
+		break;
+	case RC_NODE_MAGNIFIER_WIDTH:
 		rc.mag_width = atoi(content);
-	} else if (!strcasecmp(nodename, "height.magnifier")) {
+		break;
+	case RC_NODE_MAGNIFIER_HEIGHT:
 		rc.mag_height = atoi(content);
-	} else if (!strcasecmp(nodename, "initScale.magnifier")) {
+		break;
+	case RC_NODE_MAGNIFIER_INIT_SCALE:
 		set_float(content, &rc.mag_scale);
 		rc.mag_scale = MAX(1.0, rc.mag_scale);
-	} else if (!strcasecmp(nodename, "increment.magnifier")) {
+		break;
+	case RC_NODE_MAGNIFIER_INCREMENT:
 		set_float(content, &rc.mag_increment);
 		rc.mag_increment = MAX(0, rc.mag_increment);
-	} else if (!strcasecmp(nodename, "useFilter.magnifier")) {
+		break;
+	case RC_NODE_MAGNIFIER_USE_FILTER:
 		set_bool(content, &rc.mag_filter);
+		break;
+	default:
+		break;
 	}
 
 	return false;
 }
 
+/*
+ * Parsed config files are kept, with dotted attributes already expanded,
+ * so that a Reconfigure only has to walk the documents of unchanged files.
+ * A file counts as changed if its inode, size or mtime differ. This does
+ * not help the first read at startup.
+ *
+ * At most one document per config file is kept, since documents which
+ * are not used again by the next read are freed. A document takes
+ * roughly ten times the size of its file.
+ */
+struct config_snapshot {
+	char *path;
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+	xmlDoc *doc;
+	struct wl_list link; /* snapshots */
+};
+
+static struct wl_list snapshots;
+
 static void
 traverse(xmlNode *node)
 {
@@ -1389,22 +1825,85 @@ traverse(xmlNode *node)
 	}
 }
 
-static void
+static xmlDoc *
 rcxml_parse_xml(struct buf *b)
 {
 	int options = 0;
 	xmlDoc *d = xmlReadMemory(b->data, b->len, NULL, NULL, options);
 	if (!d) {
 		wlr_log(WLR_ERROR, "error parsing config file");
-		return;
+		return NULL;
 	}
-	xmlNode *root = xmlDocGetRootElement(d);
+	lab_xml_expand_dotted_attributes(xmlDocGetRootElement(d));
+	return d;
+}
 
-	lab_xml_expand_dotted_attributes(root);
-	traverse(root);
+static bool
+snapshot_matches(struct config_snapshot *snapshot, const char *path,
+		struct stat *st)
+{
+	return !strcmp(snapshot->path, path)
+		&& snapshot->dev == st->st_dev
+		&& snapshot->ino == st->st_ino
+		&& snapshot->size == st->st_size
+		&& snapshot->mtime.tv_sec == st->st_mtim.tv_sec
+		&& snapshot->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
 
-	xmlFreeDoc(d);
-	xmlCleanupParser();
+static void
+snapshot_destroy(struct config_snapshot *snapshot)
+{
+	wl_list_remove(&snapshot->link);
+	xmlFreeDoc(snapshot->doc);
+	free(snapshot->path);
+	free(snapshot);
+}
+
+/*
+ * Returns the parsed document for @path, taking it from @stale if the file
+ * has not changed since it was last read. Returns NULL if the file does not
+ * exist, is empty or cannot be parsed.
+ */
+static xmlDoc *
+get_config_doc(const char *path, struct wl_list *stale)
+{
+	struct stat st;
+	if (stat(path, &st) < 0) {
+		return NULL;
+	}
+
+	struct config_snapshot *snapshot;
+	wl_list_for_each(snapshot, stale, link) {
+		if (snapshot_matches(snapshot, path, &st)) {
+			wl_list_remove(&snapshot->link);
+			wl_list_append(&snapshots, &snapshot->link);
+			wlr_log(WLR_DEBUG, "config file %s unchanged", path);
+			return snapshot->doc;
+		}
+	}
+
+	struct buf b = buf_from_file(path);
+	if (!b.len) {
+		buf_reset(&b);
+		return NULL;
+	}
+	startup_profile_begin("parse config file");
+	xmlDoc *doc = rcxml_parse_xml(&b);
+	startup_profile_end();
+	buf_reset(&b);
+	if (!doc) {
+		return NULL;
+	}
+
+	snapshot = znew(*snapshot);
+	snapshot->path = xstrdup(path);
+	snapshot->dev = st.st_dev;
+	snapshot->ino = st.st_ino;
+	snapshot->size = st.st_size;
+	snapshot->mtime = st.st_mtim;
+	snapshot->doc = doc;
+	wl_list_append(&snapshots, &snapshot->link);
+	return doc;
 }
 
 static void
@@ -1422,6 +1921,7 @@ rcxml_init(void)
 
 	if (!has_run) {
 		wl_list_init(&rc.usable_area_overrides);
+		wl_list_init(&rc.render_delays);
 		wl_list_init(&rc.keybinds);
 		wl_list_init(&rc.mousebinds);
 		wl_list_init(&rc.libinput_categories);
@@ -1430,6 +1930,7 @@ rcxml_init(void)
 		wl_list_init(&rc.window_switcher.osd.fields);
 		wl_list_init(&rc.window_rules);
 		wl_list_init(&rc.touch_configs);
+		wl_list_init(&snapshots);
 	}
 	has_run = true;
 
@@ -1496,6 +1997,8 @@ rcxml_init(void)
 	rc.window_switcher.osd.style = CYCLE_OSD_STYLE_CLASSIC;
 	rc.window_switcher.osd.output_filter = CYCLE_OUTPUT_ALL;
 	rc.window_switcher.osd.thumbnail_label_format = xstrdup("%T");
+	rc.window_switcher.osd.live = false;
+	rc.window_switcher.osd.live_budget = 2.0;
 	rc.window_switcher.preview = true;
 	rc.window_switcher.outlines = true;
 	rc.window_switcher.unshade = true;
@@ -1588,26 +2091,48 @@ load_default_mouse_bindings(void)
 	wlr_log(WLR_DEBUG, "Loaded %u merged mousebinds", count);
 }
 
+/* Must agree with mousebind_the_same() */
+static guint
+hash_mousebind(gconstpointer key)
+{
+	const struct mousebind *mousebind = key;
+	guint hash = 5381;
+	hash = hash * 33 + mousebind->context;
+	hash = hash * 33 + mousebind->button;
+	hash = hash * 33 + mousebind->direction;
+	hash = hash * 33 + mousebind->mouse_event;
+	hash = hash * 33 + mousebind->modifiers;
+	return hash;
+}
+
+static gboolean
+equal_mousebind(gconstpointer a, gconstpointer b)
+{
+	return mousebind_the_same((struct mousebind *)a, (struct mousebind *)b);
+}
+
+/*
+ * Walk the bindings from the last one and drop any binding for which a
+ * later one has already been seen, so that the last definition wins.
+ */
 static void
 deduplicate_mouse_bindings(void)
 {
 	uint32_t replaced = 0;
 	uint32_t cleared = 0;
-	struct mousebind *current, *tmp, *existing;
-	wl_list_for_each_safe(existing, tmp, &rc.mousebinds, link) {
-		wl_list_for_each_reverse(current, &rc.mousebinds, link) {
-			if (existing == current) {
-				break;
-			}
-			if (mousebind_the_same(existing, current)) {
-				wl_list_remove(&existing->link);
-				action_list_free(&existing->actions);
-				free(existing);
-				replaced++;
-				break;
-			}
+	struct mousebind *current, *tmp;
+	GHashTable *seen = g_hash_table_new(hash_mousebind, equal_mousebind);
+	wl_list_for_each_reverse_safe(current, tmp, &rc.mousebinds, link) {
+		if (g_hash_table_contains(seen, current)) {
+			wl_list_remove(&current->link);
+			action_list_free(&current->actions);
+			free(current);
+			replaced++;
+			continue;
 		}
+		g_hash_table_add(seen, current);
 	}
+	g_hash_table_destroy(seen);
 	wl_list_for_each_safe(current, tmp, &rc.mousebinds, link) {
 		if (wl_list_empty(&current->actions)) {
 			wl_list_remove(&current->link);
@@ -1623,26 +2148,42 @@ deduplicate_mouse_bindings(void)
 	}
 }
 
+/* Must agree with keybind_the_same() */
+static guint
+hash_keybind(gconstpointer key)
+{
+	const struct keybind *keybind = key;
+	guint hash = 5381 * 33 + keybind->modifiers;
+	for (size_t i = 0; i < keybind->keysyms_len; i++) {
+		hash = hash * 33 + keybind->keysyms[i];
+	}
+	return hash;
+}
+
+static gboolean
+equal_keybind(gconstpointer a, gconstpointer b)
+{
+	return keybind_the_same((struct keybind *)a, (struct keybind *)b);
+}
+
 static void
 deduplicate_key_bindings(void)
 {
 	uint32_t replaced = 0;
 	uint32_t cleared = 0;
-	struct keybind *current, *tmp, *existing;
-	wl_list_for_each_safe(existing, tmp, &rc.keybinds, link) {
-		wl_list_for_each_reverse(current, &rc.keybinds, link) {
-			if (existing == current) {
-				break;
-			}
-			if (keybind_the_same(existing, current)) {
-				wl_list_remove(&existing->link);
-				action_list_free(&existing->actions);
-				keybind_destroy(existing);
-				replaced++;
-				break;
-			}
+	struct keybind *current, *tmp;
+	GHashTable *seen = g_hash_table_new(hash_keybind, equal_keybind);
+	wl_list_for_each_reverse_safe(current, tmp, &rc.keybinds, link) {
+		if (g_hash_table_contains(seen, current)) {
+			wl_list_remove(&current->link);
+			action_list_free(&current->actions);
+			keybind_destroy(current);
+			replaced++;
+			continue;
 		}
+		g_hash_table_add(seen, current);
 	}
+	g_hash_table_destroy(seen);
 	wl_list_for_each_safe(current, tmp, &rc.keybinds, link) {
 		if (wl_list_empty(&current->actions)) {
 			wl_list_remove(&current->link);
@@ -1813,6 +2354,8 @@ rule_destroy(struct window_rule *rule)
 	zfree(rule->title);
 	zfree(rule->sandbox_engine);
 	zfree(rule->sandbox_app_id);
+	match_pattern_finish(&rule->identifier_pattern);
+	match_pattern_finish(&rule->title_pattern);
 	action_list_free(&rule->actions);
 	zfree(rule);
 }
@@ -1920,6 +2463,15 @@ rcxml_read(const char *filename)
 		paths_config_create(&paths, "rc.xml");
 	}
 
+	/* Snapshots which are not used again below are freed at the end */
+	struct wl_list stale;
+	wl_list_init(&stale);
+	wl_list_insert_list(&stale, &snapshots);
+	wl_list_init(&snapshots);
+
+	debug_nodenames = getenv("LABWC_DEBUG_CONFIG_NODENAMES");
+	sort_node_names();
+
 	/* Reading file into buffer before parsing - better for unit tests */
 	bool should_merge_config = rc.merge_config;
 	struct wl_list *(*iter)(struct wl_list *list);
@@ -1937,20 +2489,26 @@ rcxml_read(const char *filename)
 	 */
 	for (struct wl_list *elm = iter(&paths); elm != &paths; elm = iter(elm)) {
 		struct path *path = wl_container_of(elm, path, link);
-		struct buf b = buf_from_file(path->string);
-		if (!b.len) {
+		xmlDoc *doc = get_config_doc(path->string, &stale);
+		if (!doc) {
 			continue;
 		}
 
 		wlr_log(WLR_INFO, "read config file %s", path->string);
 
-		rcxml_parse_xml(&b);
-		buf_reset(&b);
+		startup_profile_begin("traverse config file");
+		traverse(xmlDocGetRootElement(doc));
+		startup_profile_end();
 		if (!should_merge_config) {
 			break;
 		}
 	};
 	paths_destroy(&paths);
+
+	struct config_snapshot *snapshot, *tmp;
+	wl_list_for_each_safe(snapshot, tmp, &stale, link) {
+		snapshot_destroy(snapshot);
+	}
 	post_processing();
 	validate();
 }
@@ -1981,6 +2539,13 @@ rcxml_finish(void)
 		zfree(area);
 	}
 
+	struct render_delay_config *delay, *delay_tmp;
+	wl_list_for_each_safe(delay, delay_tmp, &rc.render_delays, link) {
+		wl_list_remove(&delay->link);
+		zfree(delay->output);
+		zfree(delay);
+	}
+
 	struct keybind *k, *k_tmp;
 	wl_list_for_each_safe(k, k_tmp, &rc.keybinds, link) {
 		wl_list_remove(&k->link);
@@ -2029,3 +2594,15 @@ rcxml_finish(void)
 	/* Reset state vars for starting fresh when Reload is triggered */
 	mouse_scroll_factor = -1;
 }
+
+void
+rcxml_finish_snapshots(void)
+{
+	struct config_snapshot *snapshot, *tmp;
+	wl_list_for_each_safe(snapshot, tmp, &snapshots, link) {
+		snapshot_destroy(snapshot);
+	}
+
+	/* Only allowed once no documents are left */
+	xmlCleanupParser();
+}
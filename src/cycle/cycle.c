@@ -6,8 +6,10 @@
 #include <wlr/util/log.h>
 #include "common/lab-scene-rect.h"
 #include "common/list.h"
+#include "common/macros.h"
 #include "common/mem.h"
 #include "common/scene-helpers.h"
+#include "common/time-helpers.h"
 #include "config/rcxml.h"
 #include "labwc.h"
 #include "node.h"
@@ -16,7 +18,9 @@
 #include "scaled-buffer/scaled-icon-buffer.h"
 #include "ssd.h"
 #include "theme.h"
+#include "thumbnail.h"
 #include "view.h"
+#include "workspaces.h"
 
 static bool init_cycle(struct server *server, struct cycle_filter filter);
 static void update_cycle(struct server *server);
@@ -82,6 +86,18 @@ get_first_view(struct wl_list *views)
 	return view;
 }
 
+/* Returns the view after the given one, wrapping around at the end */
+static struct view *
+get_next_view(struct wl_list *views, struct view *view)
+{
+	struct wl_list *link = view->cycle_link.next;
+	if (link == views) {
+		link = link->next;
+	}
+	struct view *next = wl_container_of(link, next, cycle_link);
+	return next;
+}
+
 void
 cycle_reinitialize(struct server *server)
 {
@@ -96,8 +112,10 @@ cycle_reinitialize(struct server *server)
 	struct view *selected_view_prev =
 		get_next_selected_view(server, LAB_CYCLE_DIR_BACKWARD);
 	struct cycle_filter filter = cycle->filter;
+	bool overview = cycle->overview;
 
 	destroy_cycle(server);
+	cycle->overview = overview;
 	if (init_cycle(server, filter)) {
 		/*
 		 * Preserve the selected view (or its previous view) if it's
@@ -154,16 +172,18 @@ restore_preview_node(struct server *server)
 	}
 }
 
-void
-cycle_begin(struct server *server, enum lab_cycle_dir direction,
-		struct cycle_filter filter)
+/* Return false on failure */
+static bool
+begin_cycle(struct server *server, struct cycle_filter filter, bool overview)
 {
 	if (server->input_mode != LAB_INPUT_STATE_PASSTHROUGH) {
-		return;
+		return false;
 	}
 
+	server->cycle.overview = overview;
 	if (!init_cycle(server, filter)) {
-		return;
+		server->cycle.overview = false;
+		return false;
 	}
 
 	struct view *active_view = server->active_view;
@@ -174,6 +194,17 @@ cycle_begin(struct server *server, enum lab_cycle_dir direction,
 		/* Otherwise, select the first view in the cycle list */
 		server->cycle.selected_view = get_first_view(&server->cycle.views);
 	}
+	return true;
+}
+
+void
+cycle_begin(struct server *server, enum lab_cycle_dir direction,
+		struct cycle_filter filter)
+{
+	if (!begin_cycle(server, filter, /*overview*/ false)) {
+		return;
+	}
+
 	/* Pre-select the next view in the given direction */
 	server->cycle.selected_view = get_next_selected_view(server, direction);
 
@@ -185,6 +216,48 @@ cycle_begin(struct server *server, enum lab_cycle_dir direction,
 	cursor_update_focus(server);
 }
 
+void
+cycle_overview_begin(struct server *server)
+{
+	struct cycle_filter filter = {
+		.workspace = CYCLE_WORKSPACE_ALL,
+		.output = CYCLE_OUTPUT_ALL,
+		.app_id = CYCLE_APP_ID_ALL,
+	};
+	if (!begin_cycle(server, filter, /*overview*/ true)) {
+		return;
+	}
+
+	seat_focus_override_begin(&server->seat,
+		LAB_INPUT_STATE_CYCLE, LAB_CURSOR_DEFAULT);
+	update_cycle(server);
+	cursor_update_focus(server);
+}
+
+void
+cycle_overview_step(struct server *server, enum lab_edge direction)
+{
+	assert(server->input_mode == LAB_INPUT_STATE_CYCLE);
+	struct cycle_state *cycle = &server->cycle;
+
+	int nr_steps = 1;
+	if ((direction == LAB_EDGE_TOP || direction == LAB_EDGE_BOTTOM)
+			&& !wl_list_empty(&cycle->osd_outputs)) {
+		/* Move by a whole row of the grid */
+		struct cycle_osd_output *osd_output = wl_container_of(
+			cycle->osd_outputs.next, osd_output, link);
+		nr_steps = MAX(osd_output->nr_cols, 1);
+	}
+
+	enum lab_cycle_dir dir =
+		(direction == LAB_EDGE_TOP || direction == LAB_EDGE_LEFT) ?
+		LAB_CYCLE_DIR_BACKWARD : LAB_CYCLE_DIR_FORWARD;
+	for (int i = 0; i < nr_steps; i++) {
+		cycle->selected_view = get_next_selected_view(server, dir);
+	}
+	update_cycle(server);
+}
+
 void
 cycle_step(struct server *server, enum lab_cycle_dir direction)
 {
@@ -253,8 +326,11 @@ preview_selected_view(struct view *view)
 }
 
 static struct cycle_osd_impl *
-get_osd_impl(void)
+get_osd_impl(struct server *server)
 {
+	if (server->cycle.overview) {
+		return &cycle_osd_thumbnail_impl;
+	}
 	switch (rc.window_switcher.osd.style) {
 	case CYCLE_OSD_STYLE_CLASSIC:
 		return &cycle_osd_classic_impl;
@@ -264,6 +340,88 @@ get_osd_impl(void)
 	return NULL;
 }
 
+static void
+refresh_view(struct server *server, struct view *view)
+{
+	struct cycle_osd_output *osd_output;
+	wl_list_for_each(osd_output, &server->cycle.osd_outputs, link) {
+		get_osd_impl(server)->refresh(osd_output, view);
+	}
+}
+
+/* Returns the shortest refresh period of the outputs showing the OSD */
+static uint64_t
+get_refresh_period(struct cycle_state *cycle)
+{
+	int refresh = 0; /* mHz */
+	struct cycle_osd_output *osd_output;
+	wl_list_for_each(osd_output, &cycle->osd_outputs, link) {
+		refresh = MAX(refresh, osd_output->output->wlr_output->refresh);
+	}
+	if (refresh <= 0) {
+		/* Unknown, e.g. nested; assume 60 Hz */
+		refresh = 60000;
+	}
+	return 1000000000000ULL / refresh;
+}
+
+void
+cycle_osd_update_live(struct server *server)
+{
+	struct cycle_state *cycle = &server->cycle;
+	if (server->input_mode != LAB_INPUT_STATE_CYCLE
+			|| !rc.window_switcher.osd.live
+			|| wl_list_empty(&cycle->osd_outputs)
+			|| !get_osd_impl(server)->refresh) {
+		return;
+	}
+
+	/*
+	 * Rendering itself happens asynchronously on the GPU, so this
+	 * limits the time spent on the CPU walking scene-trees and
+	 * submitting render passes before the frame is committed.
+	 *
+	 * Every thumbnail is refreshed on all outputs at once, so the
+	 * outputs rendering after the first one within a refresh period
+	 * only get what is left of its budget.
+	 */
+	uint64_t now = time_now_nsec();
+	if (now >= cycle->live_period_end) {
+		cycle->live_period_end = now + get_refresh_period(cycle);
+		cycle->live_deadline = now
+			+ (uint64_t)(rc.window_switcher.osd.live_budget * 1000000);
+	}
+	uint64_t deadline = cycle->live_deadline;
+
+	/* The selected view is always refreshed, regardless of the budget */
+	if (thumbnail_is_outdated(cycle->selected_view)) {
+		refresh_view(server, cycle->selected_view);
+	}
+
+	/* Continue round-robin where the previous frame ran out of budget */
+	struct view *start = cycle->live_next ?
+		cycle->live_next : get_first_view(&cycle->views);
+	struct view *view = start;
+	do {
+		if (view != cycle->selected_view
+				&& thumbnail_is_outdated(view)) {
+			if (time_now_nsec() >= deadline) {
+				/* Pick up from here in the next frame */
+				cycle->live_next = view;
+				struct cycle_osd_output *osd_output;
+				wl_list_for_each(osd_output,
+						&cycle->osd_outputs, link) {
+					wlr_output_schedule_frame(
+						osd_output->output->wlr_output);
+				}
+				return;
+			}
+			refresh_view(server, view);
+		}
+		view = get_next_view(&cycle->views, view);
+	} while (view != start);
+}
+
 static uint64_t
 get_outputs_by_filter(struct server *server,
 		enum cycle_output_filter output_filter)
@@ -296,18 +454,44 @@ get_outputs_by_filter(struct server *server,
 	}
 }
 
+static bool
+matches_filter(struct view *view, uint64_t cycle_outputs,
+		const char *cycle_app_id)
+{
+	if (!(cycle_outputs & view->output->id_bit)) {
+		return false;
+	}
+	if (cycle_app_id && strcmp(view->app_id, cycle_app_id) != 0) {
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Group the views by workspace (in the order of the workspaces) while
+ * keeping their relative order within each workspace.
+ */
 static void
-insert_view_ordered_by_age(struct wl_list *views, struct view *new_view)
+sort_views_by_workspace(struct server *server, struct wl_list *views)
 {
-	struct wl_list *link = views;
-	struct view *view;
-	wl_list_for_each(view, views, cycle_link) {
-		if (view->creation_id >= new_view->creation_id) {
-			break;
+	struct wl_list sorted;
+	wl_list_init(&sorted);
+
+	struct workspace *workspace;
+	wl_list_for_each(workspace, &server->workspaces.all, link) {
+		struct view *view, *tmp;
+		wl_list_for_each_safe(view, tmp, views, cycle_link) {
+			if (view->workspace == workspace) {
+				wl_list_remove(&view->cycle_link);
+				wl_list_append(&sorted, &view->cycle_link);
+			}
 		}
-		link = &view->cycle_link;
 	}
-	wl_list_insert(link, &new_view->cycle_link);
+	/* Should be empty, but don't lose any views if it isn't */
+	wl_list_insert_list(sorted.prev, views);
+
+	wl_list_init(views);
+	wl_list_insert_list(views, &sorted);
 }
 
 static void
@@ -344,28 +528,37 @@ init_cycle(struct server *server, struct cycle_filter filter)
 		cycle_app_id = server->active_view->app_id;
 	}
 
+	/*
+	 * The server keeps the views both in focus (stacking) order and in
+	 * order of creation, so the cycle list is built in a single pass
+	 * without having to sort it.
+	 */
 	struct view *view;
-	for_each_view(view, &server->views, criteria) {
-		if (!(cycle_outputs & view->output->id_bit)) {
-			continue;
-		}
-		if (cycle_app_id && strcmp(view->app_id, cycle_app_id) != 0) {
-			continue;
+	if (rc.window_switcher.order == WINDOW_SWITCHER_ORDER_AGE) {
+		for_each_view_by_age(view, &server->views_by_age, criteria) {
+			if (matches_filter(view, cycle_outputs, cycle_app_id)) {
+				wl_list_append(&server->cycle.views,
+					&view->cycle_link);
+			}
 		}
-
-		if (rc.window_switcher.order == WINDOW_SWITCHER_ORDER_AGE) {
-			insert_view_ordered_by_age(&server->cycle.views, view);
-		} else {
-			wl_list_append(&server->cycle.views, &view->cycle_link);
+	} else {
+		for_each_view(view, &server->views, criteria) {
+			if (matches_filter(view, cycle_outputs, cycle_app_id)) {
+				wl_list_append(&server->cycle.views,
+					&view->cycle_link);
+			}
 		}
 	}
+	if (server->cycle.overview) {
+		sort_views_by_workspace(server, &server->cycle.views);
+	}
 	if (wl_list_empty(&server->cycle.views)) {
 		wlr_log(WLR_DEBUG, "no views to switch between");
 		return false;
 	}
 	server->cycle.filter = filter;
 
-	if (rc.window_switcher.osd.show) {
+	if (rc.window_switcher.osd.show || server->cycle.overview) {
 		/* Create OSD */
 		uint64_t osd_outputs = get_outputs_by_filter(server,
 				rc.window_switcher.osd.output_filter);
@@ -383,7 +576,7 @@ init_cycle(struct server *server, struct cycle_filter filter)
 			osd_output->output = output;
 			wl_list_init(&osd_output->items);
 
-			get_osd_impl()->init(osd_output);
+			get_osd_impl(server)->init(osd_output);
 
 			osd_output->tree_destroy.notify = handle_osd_tree_destroy;
 			wl_signal_add(&osd_output->tree->node.events.destroy,
@@ -399,13 +592,18 @@ update_cycle(struct server *server)
 {
 	struct cycle_state *cycle = &server->cycle;
 
-	if (rc.window_switcher.osd.show) {
+	if (rc.window_switcher.osd.show || cycle->overview) {
 		struct cycle_osd_output *osd_output;
 		wl_list_for_each(osd_output, &cycle->osd_outputs, link) {
-			get_osd_impl()->update(osd_output);
+			get_osd_impl(server)->update(osd_output);
 		}
 	}
 
+	/* The overview shows windows of all workspaces side by side */
+	if (cycle->overview) {
+		return;
+	}
+
 	if (rc.window_switcher.preview) {
 		preview_selected_view(cycle->selected_view);
 	}
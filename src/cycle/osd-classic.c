@@ -26,6 +26,63 @@ struct cycle_osd_classic_item {
 	struct wlr_scene_tree *normal_tree, *active_tree;
 };
 
+static int
+get_osd_width(struct output *output)
+{
+	struct window_switcher_classic_theme *switcher_theme =
+		&output->server->theme->osd_window_switcher_classic;
+	if (!switcher_theme->width_is_percent) {
+		return switcher_theme->width;
+	}
+	struct wlr_box output_box;
+	wlr_output_layout_get_box(output->server->output_layout,
+		output->wlr_output, &output_box);
+	return output_box.width * switcher_theme->width / 100;
+}
+
+/* Returns the width of the area available for text fields */
+static int
+get_field_widths_sum(struct theme *theme, int osd_width)
+{
+	struct window_switcher_classic_theme *switcher_theme =
+		&theme->osd_window_switcher_classic;
+	int padding = theme->osd_border_width + switcher_theme->padding;
+	int nr_fields = wl_list_length(&rc.window_switcher.osd.fields);
+	return osd_width - 2 * padding
+		- 2 * switcher_theme->item_active_border_width
+		- (nr_fields + 1) * switcher_theme->item_padding_x;
+}
+
+static int
+get_field_width(struct cycle_osd_field *field, int field_widths_sum)
+{
+	return field_widths_sum * field->width / 100.0;
+}
+
+static int
+get_icon_size(struct theme *theme, int field_width)
+{
+	return MIN(field_width,
+		theme->osd_window_switcher_classic.item_icon_size);
+}
+
+int
+cycle_osd_classic_get_icon_size(struct output *output)
+{
+	struct theme *theme = output->server->theme;
+	int field_widths_sum =
+		get_field_widths_sum(theme, get_osd_width(output));
+
+	struct cycle_osd_field *field;
+	wl_list_for_each(field, &rc.window_switcher.osd.fields, link) {
+		if (field->content == LAB_FIELD_ICON) {
+			return get_icon_size(theme,
+				get_field_width(field, field_widths_sum));
+		}
+	}
+	return 0;
+}
+
 static void
 create_fields_scene(struct server *server, struct view *view,
 		struct wlr_scene_tree *parent, const float *text_color,
@@ -37,13 +94,12 @@ create_fields_scene(struct server *server, struct view *view,
 
 	struct cycle_osd_field *field;
 	wl_list_for_each(field, &rc.window_switcher.osd.fields, link) {
-		int field_width = field_widths_sum * field->width / 100.0;
+		int field_width = get_field_width(field, field_widths_sum);
 		struct wlr_scene_node *node = NULL;
 		int height = -1;
 
 		if (field->content == LAB_FIELD_ICON) {
-			int icon_size = MIN(field_width,
-				switcher_theme->item_icon_size);
+			int icon_size = get_icon_size(theme, field_width);
 			struct scaled_icon_buffer *icon_buffer =
 				scaled_icon_buffer_create(parent,
 					server, icon_size, icon_size);
@@ -93,10 +149,7 @@ cycle_osd_classic_init(struct cycle_osd_output *osd_output)
 	wlr_output_layout_get_box(server->output_layout, output->wlr_output,
 		&output_box);
 
-	int w = switcher_theme->width;
-	if (switcher_theme->width_is_percent) {
-		w = output_box.width * switcher_theme->width / 100;
-	}
+	int w = get_osd_width(output);
 	int workspace_name_h = 0;
 	if (show_workspace) {
 		/* workspace indicator */
@@ -148,12 +201,7 @@ cycle_osd_classic_init(struct cycle_osd_output *osd_output)
 		y += switcher_theme->item_height;
 	}
 
-	int nr_fields = wl_list_length(&rc.window_switcher.osd.fields);
-
-	/* This is the width of the area available for text fields */
-	int field_widths_sum = w - 2 * padding
-		- 2 * switcher_theme->item_active_border_width
-		- (nr_fields + 1) * switcher_theme->item_padding_x;
+	int field_widths_sum = get_field_widths_sum(theme, w);
 	if (field_widths_sum <= 0) {
 		wlr_log(WLR_ERROR, "Not enough spaces for osd contents");
 		goto error;
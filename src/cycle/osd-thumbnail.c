@@ -1,7 +1,5 @@
 // SPDX-License-Identifier: GPL-2.0-only
 #include <assert.h>
-#include <wlr/render/allocator.h>
-#include <wlr/render/swapchain.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_scene.h>
 #include "config/rcxml.h"
@@ -17,6 +15,7 @@
 #include "scaled-buffer/scaled-font-buffer.h"
 #include "scaled-buffer/scaled-icon-buffer.h"
 #include "theme.h"
+#include "thumbnail.h"
 #include "view.h"
 
 struct cycle_osd_thumbnail_item {
@@ -24,82 +23,44 @@ struct cycle_osd_thumbnail_item {
 	struct scaled_font_buffer *normal_label;
 	struct scaled_font_buffer *active_label;
 	struct lab_scene_rect *active_bg;
+	struct wlr_scene_buffer *thumb;
+	/* Area of the item in which the thumbnail is centered */
+	struct wlr_box thumb_bounds;
+};
+
+/* Items are scaled up by at most this factor in the overview */
+#define OVERVIEW_MAX_ITEM_SCALE 3.0
+
+struct items_geometry {
+	int item_width, item_height;
+	int nr_cols, nr_rows, nr_visible_rows;
 };
 
 static void
-render_node(struct server *server, struct wlr_render_pass *pass,
-		struct wlr_scene_node *node, int x, int y)
+update_thumbnail(struct cycle_osd_thumbnail_item *item, struct output *output)
 {
-	switch (node->type) {
-	case WLR_SCENE_NODE_TREE: {
-		struct wlr_scene_tree *tree = wlr_scene_tree_from_node(node);
-		struct wlr_scene_node *child;
-		wl_list_for_each(child, &tree->children, link) {
-			render_node(server, pass, child, x + node->x, y + node->y);
-		}
-		break;
-	}
-	case WLR_SCENE_NODE_BUFFER: {
-		struct wlr_scene_buffer *scene_buffer =
-			wlr_scene_buffer_from_node(node);
-		if (!scene_buffer->buffer) {
-			break;
-		}
-		struct wlr_texture *texture = wlr_texture_from_buffer(
-			server->renderer, scene_buffer->buffer);
-		if (!texture) {
-			break;
-		}
-		wlr_render_pass_add_texture(pass, &(struct wlr_render_texture_options){
-			.texture = texture,
-			.src_box = scene_buffer->src_box,
-			.dst_box = {
-				.x = x,
-				.y = y,
-				.width = scene_buffer->dst_width,
-				.height = scene_buffer->dst_height,
-			},
-			.transform = scene_buffer->transform,
-		});
-		wlr_texture_destroy(texture);
-		break;
-	}
-	case WLR_SCENE_NODE_RECT:
-		/* should be unreached */
-		wlr_log(WLR_ERROR, "ignoring rect");
-		break;
-	}
-}
+	struct view *view = item->base.view;
+	struct wlr_box *bounds = &item->thumb_bounds;
+	struct wlr_buffer *buffer = thumbnail_get(output, view,
+		bounds->width, bounds->height);
 
-static struct wlr_buffer *
-render_thumb(struct output *output, struct view *view)
-{
-	if (!view->content_tree) {
-		/*
-		 * Defensive. Could possibly occur if view was unmapped
-		 * with OSD already displayed.
-		 */
-		return NULL;
-	}
-	struct server *server = output->server;
-	struct wlr_buffer *buffer = wlr_allocator_create_buffer(server->allocator,
-		view->current.width, view->current.height,
-		&output->wlr_output->swapchain->format);
-	struct wlr_render_pass *pass = wlr_renderer_begin_buffer_pass(
-		server->renderer, buffer, NULL);
-	render_node(server, pass, &view->content_tree->node, 0, 0);
-	if (!wlr_render_pass_submit(pass)) {
-		wlr_log(WLR_ERROR, "failed to submit render pass");
-		wlr_buffer_drop(buffer);
-		return NULL;
+	wlr_scene_buffer_set_buffer(item->thumb, buffer);
+	if (!buffer) {
+		return;
 	}
-	return buffer;
+
+	/* The buffer is in physical pixels; size it in logical ones */
+	struct wlr_box box = box_fit_within(view->current.width,
+		view->current.height, bounds);
+	wlr_scene_buffer_set_dest_size(item->thumb, box.width, box.height);
+	wlr_scene_node_set_position(&item->thumb->node, box.x, box.y);
 }
 
 static struct scaled_font_buffer *
 create_label(struct wlr_scene_tree *parent, struct view *view,
 		struct window_switcher_thumbnail_theme *switcher_theme,
-		const float *text_color, const float *bg_color, int y)
+		int item_width, const float *text_color, const float *bg_color,
+		int y)
 {
 	struct buf buf = BUF_INIT;
 	cycle_osd_field_set_custom(&buf, view,
@@ -107,28 +68,29 @@ create_label(struct wlr_scene_tree *parent, struct view *view,
 	struct scaled_font_buffer *buffer =
 		scaled_font_buffer_create(parent);
 	scaled_font_buffer_update(buffer, buf.data,
-		switcher_theme->item_width - 2 * switcher_theme->item_padding,
+		item_width - 2 * switcher_theme->item_padding,
 		&rc.font_osd, text_color, bg_color);
 	buf_reset(&buf);
 	wlr_scene_node_set_position(&buffer->scene_buffer->node,
-		(switcher_theme->item_width - buffer->width) / 2, y);
+		(item_width - buffer->width) / 2, y);
 	return buffer;
 }
 
 static struct cycle_osd_thumbnail_item *
 create_item_scene(struct wlr_scene_tree *parent, struct view *view,
-		struct cycle_osd_output *osd_output)
+		struct cycle_osd_output *osd_output, int item_width,
+		int item_height)
 {
 	struct server *server = osd_output->output->server;
 	struct theme *theme = server->theme;
 	struct window_switcher_thumbnail_theme *switcher_theme =
 		&theme->osd_window_switcher_thumbnail;
 	int padding = theme->border_width + switcher_theme->item_padding;
-	int title_y = switcher_theme->item_height - padding - switcher_theme->title_height;
+	int title_y = item_height - padding - switcher_theme->title_height;
 	struct wlr_box thumb_bounds = {
 		.x = padding,
 		.y = padding,
-		.width = switcher_theme->item_width - 2 * padding,
+		.width = item_width - 2 * padding,
 		.height = title_y - 2 * padding,
 	};
 	if (thumb_bounds.width <= 0 || thumb_bounds.height <= 0) {
@@ -149,36 +111,27 @@ create_item_scene(struct wlr_scene_tree *parent, struct view *view,
 		.nr_borders = 1,
 		.border_width = switcher_theme->item_active_border_width,
 		.bg_color = switcher_theme->item_active_bg_color,
-		.width = switcher_theme->item_width,
-		.height = switcher_theme->item_height,
+		.width = item_width,
+		.height = item_height,
 	};
 	item->active_bg = lab_scene_rect_create(tree, &opts);
 
 	/* hitbox for mouse clicks */
-	wlr_scene_rect_create(tree, switcher_theme->item_width,
-		switcher_theme->item_height, (float[4]) {0});
+	wlr_scene_rect_create(tree, item_width, item_height, (float[4]) {0});
 
 	/* thumbnail */
-	struct wlr_buffer *thumb_buffer = render_thumb(osd_output->output, view);
-	if (thumb_buffer) {
-		struct wlr_scene_buffer *thumb_scene_buffer =
-			wlr_scene_buffer_create(tree, thumb_buffer);
-		wlr_buffer_drop(thumb_buffer);
-		struct wlr_box thumb_box = box_fit_within(
-			thumb_buffer->width, thumb_buffer->height,
-			&thumb_bounds);
-		wlr_scene_buffer_set_dest_size(thumb_scene_buffer,
-			thumb_box.width, thumb_box.height);
-		wlr_scene_node_set_position(&thumb_scene_buffer->node,
-			thumb_box.x, thumb_box.y);
-	}
+	item->thumb = wlr_scene_buffer_create(tree, NULL);
+	wlr_scene_buffer_set_filter_mode(item->thumb,
+		WLR_SCALE_FILTER_BILINEAR);
+	item->thumb_bounds = thumb_bounds;
+	update_thumbnail(item, osd_output->output);
 
 	/* title */
 	item->normal_label = create_label(tree, view,
-		switcher_theme, theme->osd_label_text_color,
+		switcher_theme, item_width, theme->osd_label_text_color,
 		theme->osd_bg_color, title_y);
 	item->active_label = create_label(tree, view,
-		switcher_theme, theme->osd_label_text_color,
+		switcher_theme, item_width, theme->osd_label_text_color,
 		switcher_theme->item_active_bg_color, title_y);
 
 	/* icon */
@@ -186,7 +139,7 @@ create_item_scene(struct wlr_scene_tree *parent, struct view *view,
 	struct scaled_icon_buffer *icon_buffer =
 		scaled_icon_buffer_create(tree, server, icon_size, icon_size);
 	scaled_icon_buffer_set_view(icon_buffer, view);
-	int x = (switcher_theme->item_width - icon_size) / 2;
+	int x = (item_width - icon_size) / 2;
 	int y = title_y - padding - icon_size + 10; /* slide by 10px */
 	wlr_scene_node_set_position(&icon_buffer->scene_buffer->node, x, y);
 
@@ -195,7 +148,7 @@ create_item_scene(struct wlr_scene_tree *parent, struct view *view,
 
 static void
 get_items_geometry(struct output *output, int nr_thumbs,
-		int *nr_cols, int *nr_rows, int *nr_visible_rows)
+		struct items_geometry *geo)
 {
 	struct theme *theme = output->server->theme;
 	struct window_switcher_thumbnail_theme *switcher_theme =
@@ -210,23 +163,74 @@ get_items_geometry(struct output *output, int nr_thumbs,
 		max_bg_width = output_width * switcher_theme->max_width / 100;
 	}
 
-	*nr_rows = 1;
-	*nr_cols = nr_thumbs;
+	geo->item_width = switcher_theme->item_width;
+	geo->item_height = switcher_theme->item_height;
+	geo->nr_rows = 1;
+	geo->nr_cols = nr_thumbs;
 	while (1) {
-		assert(*nr_rows <= nr_thumbs);
-		int bg_width = *nr_cols * switcher_theme->item_width + 2 * padding;
+		assert(geo->nr_rows <= nr_thumbs);
+		int bg_width = geo->nr_cols * geo->item_width + 2 * padding;
 		if (bg_width < max_bg_width) {
 			break;
 		}
-		if (*nr_rows >= nr_thumbs) {
+		if (geo->nr_rows >= nr_thumbs) {
 			break;
 		}
-		(*nr_rows)++;
-		*nr_cols = ceilf((float)nr_thumbs / *nr_rows);
+		geo->nr_rows++;
+		geo->nr_cols = ceilf((float)nr_thumbs / geo->nr_rows);
+	}
+
+	geo->nr_visible_rows = MIN(geo->nr_rows,
+		(output_height - 2 * padding) / geo->item_height);
+}
+
+/*
+ * In the overview, pick the number of columns which allows the items to
+ * be scaled up the most (preserving their aspect ratio) while all of them
+ * still fit on the output. If they don't fit even at their regular size,
+ * they are not scaled and the overview becomes scrollable.
+ */
+static void
+get_overview_geometry(struct output *output, int nr_thumbs,
+		struct items_geometry *geo)
+{
+	struct theme *theme = output->server->theme;
+	struct window_switcher_thumbnail_theme *switcher_theme =
+		&theme->osd_window_switcher_thumbnail;
+	int output_width, output_height;
+	wlr_output_effective_resolution(output->wlr_output,
+		&output_width, &output_height);
+	int padding = theme->osd_border_width + switcher_theme->padding;
+	int avail_width = output_width - 2 * padding;
+	int avail_height = output_height - 2 * padding;
+
+	double best_scale = 0;
+	int best_nr_cols = 1;
+	for (int nr_cols = 1; nr_cols <= nr_thumbs; nr_cols++) {
+		int nr_rows = (nr_thumbs + nr_cols - 1) / nr_cols;
+		double scale = MIN(
+			(double)avail_width / (nr_cols * switcher_theme->item_width),
+			(double)avail_height / (nr_rows * switcher_theme->item_height));
+		if (scale > best_scale) {
+			best_scale = scale;
+			best_nr_cols = nr_cols;
+		}
 	}
 
-	*nr_visible_rows = MIN(*nr_rows,
-		(output_height - 2 * padding) / switcher_theme->item_height);
+	if (best_scale < 1.0) {
+		/* Use as many regular sized columns as fit and scroll */
+		best_scale = 1.0;
+		best_nr_cols = MAX(1, avail_width / switcher_theme->item_width);
+		best_nr_cols = MIN(best_nr_cols, nr_thumbs);
+	}
+	best_scale = MIN(best_scale, OVERVIEW_MAX_ITEM_SCALE);
+
+	geo->item_width = switcher_theme->item_width * best_scale;
+	geo->item_height = switcher_theme->item_height * best_scale;
+	geo->nr_cols = best_nr_cols;
+	geo->nr_rows = (nr_thumbs + best_nr_cols - 1) / best_nr_cols;
+	geo->nr_visible_rows = MAX(1, MIN(geo->nr_rows,
+		avail_height / geo->item_height));
 }
 
 static void
@@ -244,26 +248,32 @@ cycle_osd_thumbnail_init(struct cycle_osd_output *osd_output)
 
 	int nr_views = wl_list_length(&server->cycle.views);
 	assert(nr_views > 0);
-	int nr_cols, nr_rows, nr_visible_rows;
-	get_items_geometry(output, nr_views, &nr_cols, &nr_rows, &nr_visible_rows);
+	struct items_geometry geo;
+	if (server->cycle.overview) {
+		get_overview_geometry(output, nr_views, &geo);
+	} else {
+		get_items_geometry(output, nr_views, &geo);
+	}
+	osd_output->nr_cols = geo.nr_cols;
 
 	/* items */
 	struct view *view;
 	int index = 0;
 	wl_list_for_each(view, &server->cycle.views, cycle_link) {
 		struct cycle_osd_thumbnail_item *item = create_item_scene(
-			osd_output->items_tree, view, osd_output);
+			osd_output->items_tree, view, osd_output,
+			geo.item_width, geo.item_height);
 		if (!item) {
 			break;
 		}
-		int x = (index % nr_cols) * switcher_theme->item_width + padding;
-		int y = (index / nr_cols) * switcher_theme->item_height + padding;
+		int x = (index % geo.nr_cols) * geo.item_width + padding;
+		int y = (index / geo.nr_cols) * geo.item_height + padding;
 		wlr_scene_node_set_position(&item->base.tree->node, x, y);
 		index++;
 	}
 
-	int items_width = switcher_theme->item_width * nr_cols;
-	int items_height = switcher_theme->item_height * nr_visible_rows;
+	int items_width = geo.item_width * geo.nr_cols;
+	int items_height = geo.item_height * geo.nr_visible_rows;
 
 	struct wlr_box scrollbar_area = {
 		.x = padding + items_width - SCROLLBAR_W,
@@ -272,7 +282,7 @@ cycle_osd_thumbnail_init(struct cycle_osd_output *osd_output)
 		.height = items_height,
 	};
 	cycle_osd_scroll_init(osd_output, scrollbar_area,
-		switcher_theme->item_height, nr_cols, nr_rows, nr_visible_rows,
+		geo.item_height, geo.nr_cols, geo.nr_rows, geo.nr_visible_rows,
 		switcher_theme->item_active_border_color,
 		switcher_theme->item_active_bg_color);
 
@@ -315,7 +325,21 @@ cycle_osd_thumbnail_update(struct cycle_osd_output *osd_output)
 	}
 }
 
+static void
+cycle_osd_thumbnail_refresh(struct cycle_osd_output *osd_output,
+		struct view *view)
+{
+	struct cycle_osd_thumbnail_item *item;
+	wl_list_for_each(item, &osd_output->items, base.link) {
+		if (item->base.view == view) {
+			update_thumbnail(item, osd_output->output);
+			return;
+		}
+	}
+}
+
 struct cycle_osd_impl cycle_osd_thumbnail_impl = {
 	.init = cycle_osd_thumbnail_init,
 	.update = cycle_osd_thumbnail_update,
+	.refresh = cycle_osd_thumbnail_refresh,
 };
@@ -9,9 +9,11 @@
 #include <wlr/types/wlr_subcompositor.h>
 #include <wlr/types/wlr_xdg_shell.h>
 #include "common/scene-helpers.h"
+#include "common/string-helpers.h"
 #include "dnd.h"
 #include "labwc.h"
 #include "layers.h"
+#include "layout-transaction.h"
 #include "node.h"
 #include "output.h"
 #include "ssd.h"
@@ -22,6 +24,63 @@
 #include <wlr/xwayland.h>
 #endif
 
+/* Records which outputs changed since views were last arranged */
+static void
+update_output_arrangement(struct server *server)
+{
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		struct wlr_box box = {0};
+		if (output_is_usable(output)) {
+			wlr_output_layout_get_box(server->output_layout,
+				output->wlr_output, &box);
+		}
+		output->arrangement_changed =
+			!wlr_box_equal(&box, &output->arranged_box)
+			|| !wlr_box_equal(&output->usable_area,
+				&output->arranged_usable_area);
+		output->arranged_box = box;
+		output->arranged_usable_area = output->usable_area;
+	}
+}
+
+/*
+ * A view placed on an output which did not change keeps its geometry.
+ * Views evacuated from another output are always adjusted, since that
+ * output may have come back.
+ */
+static bool
+view_needs_arrangement(struct view *view)
+{
+	struct output *output = view->output;
+	if (!output_is_usable(output) || output->arrangement_changed) {
+		return true;
+	}
+	return !str_equal(view->last_placement.output_name,
+		output->wlr_output->name);
+}
+
+void
+desktop_arrange_views_for_layout_change(struct server *server)
+{
+	update_output_arrangement(server);
+
+	layout_transaction_begin(server);
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (wlr_box_empty(&view->pending)) {
+			continue;
+		}
+		if (view_needs_arrangement(view)) {
+			view_adjust_for_layout_change(view);
+		} else {
+			/* It may still span onto an added or removed output */
+			view_update_outputs(view);
+		}
+	}
+	layout_transaction_commit(server);
+}
+
 void
 desktop_arrange_all_views(struct server *server)
 {
@@ -35,12 +94,15 @@ desktop_arrange_all_views(struct server *server)
 	 * still unmapped. We do want to adjust the geometry of those
 	 * views.
 	 */
+	update_output_arrangement(server);
+	layout_transaction_begin(server);
 	struct view *view;
 	wl_list_for_each(view, &server->views, link) {
 		if (!wlr_box_empty(&view->pending)) {
 			view_adjust_for_layout_change(view);
 		}
 	}
+	layout_transaction_commit(server);
 }
 
 static void
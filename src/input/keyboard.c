@@ -141,7 +141,9 @@ handle_modifiers(struct wl_listener *listener, void *data)
 		overlay_update(seat);
 	}
 
-	bool cycling = server->input_mode == LAB_INPUT_STATE_CYCLE;
+	/* The overview stays open until a window is explicitly picked */
+	bool cycling = server->input_mode == LAB_INPUT_STATE_CYCLE
+		&& !server->cycle.overview;
 
 	if ((cycling || seat->workspace_osd_shown_by_modifier)
 			&& !keyboard_get_all_modifiers(seat)) {
@@ -448,6 +450,36 @@ handle_menu_keys(struct server *server, struct keysyms *syms)
 	}
 }
 
+/* Returns true if the keystroke is consumed */
+static bool
+handle_overview_key(struct server *server, struct keyinfo *keyinfo)
+{
+	for (int i = 0; i < keyinfo->translated.nr_syms; i++) {
+		switch (keyinfo->translated.syms[i]) {
+		case XKB_KEY_Escape:
+			cycle_finish(server, /*switch_focus*/ false);
+			return true;
+		case XKB_KEY_Return:
+		case XKB_KEY_KP_Enter:
+			cycle_finish(server, /*switch_focus*/ true);
+			return true;
+		case XKB_KEY_Up:
+			cycle_overview_step(server, LAB_EDGE_TOP);
+			return true;
+		case XKB_KEY_Down:
+			cycle_overview_step(server, LAB_EDGE_BOTTOM);
+			return true;
+		case XKB_KEY_Left:
+			cycle_overview_step(server, LAB_EDGE_LEFT);
+			return true;
+		case XKB_KEY_Right:
+			cycle_overview_step(server, LAB_EDGE_RIGHT);
+			return true;
+		}
+	}
+	return false;
+}
+
 /* Returns true if the keystroke is consumed */
 static bool
 handle_cycle_view_key(struct server *server, struct keyinfo *keyinfo)
@@ -456,6 +488,10 @@ handle_cycle_view_key(struct server *server, struct keyinfo *keyinfo)
 		return false;
 	}
 
+	if (server->cycle.overview) {
+		return handle_overview_key(server, keyinfo);
+	}
+
 	/* cycle to next */
 	for (int i = 0; i < keyinfo->translated.nr_syms; i++) {
 		if (keyinfo->translated.syms[i] == XKB_KEY_Escape) {
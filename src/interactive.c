@@ -96,7 +96,8 @@ interactive_begin(struct view *view, enum input_mode mode, enum lab_edge edges)
 	}
 
 	/* Prevent moving/resizing fixed-position and panel-like views */
-	if (window_rules_get_property(view, "fixedPosition") == LAB_PROP_TRUE
+	if (window_rules_get_property(view, LAB_RULE_PROP_FIXED_POSITION)
+				== LAB_PROP_TRUE
 			|| view_has_strut_partial(view)) {
 		return;
 	}
@@ -19,9 +19,12 @@
 #include "common/mem.h"
 #include "common/string-helpers.h"
 #include "labwc.h"
+#include "layout-transaction.h"
 #include "output.h"
+#include "output-stats.h"
 #include "view.h"
 #include "workspaces.h"
+#include "xwayland.h"
 
 #define IPC_BUF_SIZE 4096
 #define IPC_MAX_RECV_BUF (64 * 1024)
@@ -438,13 +441,19 @@ handle_query_workspaces_json(struct server *server, int client_fd)
  *   list-views-json                - JSON document with mapped views + geometry
  *   list-workspaces                - list workspaces and current index
  *   list-workspaces-json           - JSON document with workspace list + current
+ *   output-stats                   - frame timing/damage statistics per output
+ *   configure-stats                - slowest clients to respond to configures
+ *   xwm-stats                      - number of batched XWM requests and flushes
  *   workspace-add [name=...]       - add workspace (name may be percent-encoded)
  *   workspace-rename index=N name=... - rename workspace (percent-encoded name)
  *   workspace-remove index=N       - remove workspace by 1-based index
  *   subscribe-events               - stream EVENT lines on compositor changes
  *   ping                           - respond with OK (connection test)
  *
- * Each command line is executed immediately.
+ * Each command line is executed as soon as it is received. Geometry
+ * changes made by command lines received together are part of one layout
+ * transaction though, so they appear on screen in a single frame once all
+ * resized views have responded.
  */
 static void
 handle_command(struct ipc_client *client, char *line)
@@ -488,6 +497,34 @@ handle_command(struct ipc_client *client, char *line)
 		return;
 	}
 
+	if (!strcasecmp(line, "output-stats")) {
+		struct buf response = BUF_INIT;
+		output_stats_print(server, &response);
+		(void)ipc_send_raw(client_fd, response.data, (size_t)response.len);
+		buf_reset(&response);
+		return;
+	}
+
+	if (!strcasecmp(line, "configure-stats")) {
+		struct buf response = BUF_INIT;
+		xdg_shell_print_configure_stats(&response);
+		(void)ipc_send_raw(client_fd, response.data, (size_t)response.len);
+		buf_reset(&response);
+		return;
+	}
+
+	if (!strcasecmp(line, "xwm-stats")) {
+#if HAVE_XWAYLAND
+		struct buf response = BUF_INIT;
+		xwayland_print_stats(server, &response);
+		(void)ipc_send_raw(client_fd, response.data, (size_t)response.len);
+		buf_reset(&response);
+#else
+		(void)ipc_send_str(client_fd, "ERROR xwayland support not built\n");
+#endif
+		return;
+	}
+
 	if (!strncasecmp(line, "workspace-add", strlen("workspace-add"))) {
 		char *save = NULL;
 		char *cmd = strtok_r(line, " \t", &save);
@@ -683,6 +720,8 @@ handle_client_readable(int fd, uint32_t mask, void *data)
 		return 0;
 	}
 
+	/* Commands received together are shown together */
+	layout_transaction_begin(client->server);
 	char *start = client->recv_buf.data;
 	char *nl;
 	while ((nl = strchr(start, '\n'))) {
@@ -690,6 +729,7 @@ handle_client_readable(int fd, uint32_t mask, void *data)
 		handle_command(client, start);
 		start = nl + 1;
 	}
+	layout_transaction_commit(client->server);
 
 	/* Keep any remaining partial line */
 	if (*start) {
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include "layout-transaction.h"
+#include <assert.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
+#include <wlr/util/log.h>
+#include "labwc.h"
+#include "output.h"
+#include "view.h"
+
+/*
+ * Upper bound for holding back repaints. Clients which take longer are
+ * shown with their old size for a moment, like without a transaction.
+ */
+#define LAYOUT_TRANSACTION_TIMEOUT_MS 150
+
+static struct {
+	struct server *server;
+	/* Nesting level of layout_transaction_begin() */
+	int depth;
+	/* Number of views which have not responded yet */
+	int nr_waiting;
+	/* Whether views took part since the last finish_transaction() */
+	bool active;
+	struct wl_event_source *timer;
+} transaction;
+
+static void
+finish_transaction(void)
+{
+	struct server *server = transaction.server;
+
+	if (transaction.timer) {
+		wl_event_source_remove(transaction.timer);
+		transaction.timer = NULL;
+	}
+	if (transaction.nr_waiting) {
+		wlr_log(WLR_DEBUG, "layout transaction timed out waiting "
+			"for %d views", transaction.nr_waiting);
+		struct view *view;
+		wl_list_for_each(view, &server->views, link) {
+			view->in_layout_transaction = false;
+		}
+		transaction.nr_waiting = 0;
+	}
+	transaction.active = false;
+
+	/* Outputs were not committed while repainting was held back */
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (output_is_usable(output)) {
+			wlr_output_schedule_frame(output->wlr_output);
+		}
+	}
+}
+
+static int
+handle_timeout(void *data)
+{
+	finish_transaction();
+	return 0;
+}
+
+void
+layout_transaction_begin(struct server *server)
+{
+	transaction.server = server;
+	transaction.depth++;
+}
+
+void
+layout_transaction_commit(struct server *server)
+{
+	assert(transaction.depth > 0);
+	if (--transaction.depth || !transaction.active) {
+		return;
+	}
+	if (!transaction.nr_waiting) {
+		/* All views responded before the outermost commit */
+		finish_transaction();
+		return;
+	}
+	if (!transaction.timer) {
+		transaction.timer = wl_event_loop_add_timer(
+			server->wl_event_loop, handle_timeout, NULL);
+		wl_event_source_timer_update(transaction.timer,
+			LAYOUT_TRANSACTION_TIMEOUT_MS);
+	}
+}
+
+void
+layout_transaction_add_view(struct view *view)
+{
+	if (!transaction.depth && !transaction.nr_waiting) {
+		return;
+	}
+	/* Only visible views can mix old and new layouts on screen */
+	if (view->in_layout_transaction || !view->mapped
+			|| !view->scene_tree->node.enabled) {
+		return;
+	}
+	view->in_layout_transaction = true;
+	transaction.nr_waiting++;
+	transaction.active = true;
+}
+
+void
+layout_transaction_view_ready(struct view *view)
+{
+	if (!view->in_layout_transaction) {
+		return;
+	}
+	view->in_layout_transaction = false;
+	assert(transaction.nr_waiting > 0);
+	if (!--transaction.nr_waiting && !transaction.depth) {
+		finish_transaction();
+	}
+}
+
+bool
+layout_transaction_is_holding(struct output *output)
+{
+	if (!transaction.nr_waiting) {
+		return false;
+	}
+
+	struct server *server = output->server;
+	struct wlr_box output_box;
+	wlr_output_layout_get_box(server->output_layout, output->wlr_output,
+		&output_box);
+
+	/* Only hold outputs showing the old or new geometry of a view */
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (!view->in_layout_transaction) {
+			continue;
+		}
+		struct wlr_box intersection;
+		if ((view->outputs & output->id_bit)
+				|| wlr_box_intersection(&intersection,
+					&output_box, &view->pending)) {
+			return true;
+		}
+	}
+	return false;
+}
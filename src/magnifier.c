@@ -2,6 +2,7 @@
 
 #include "magnifier.h"
 #include <assert.h>
+#include <math.h>
 #include <wlr/render/allocator.h>
 #include <wlr/render/swapchain.h>
 #include <wlr/types/wlr_cursor.h>
@@ -9,6 +10,7 @@
 #include <wlr/types/wlr_scene.h>
 #include <wlr/util/transform.h>
 #include "common/box.h"
+#include "common/macros.h"
 #include "config/rcxml.h"
 #include "labwc.h"
 #include "output.h"
@@ -21,6 +23,84 @@ static double mag_scale = 0.0;
 static struct wlr_buffer *tmp_buffer = NULL;
 static struct wlr_texture *tmp_texture = NULL;
 
+/*
+ * Textures of recently used output buffers. Outputs cycle through the
+ * few buffers of their swapchain, so the textures can be reused instead
+ * of importing the output buffer again on every frame.
+ */
+#define NR_CACHED_TEXTURES 4
+
+static struct cached_texture {
+	struct wlr_buffer *buffer;
+	struct wlr_texture *texture;
+	struct wl_listener buffer_destroy;
+} cached_textures[NR_CACHED_TEXTURES];
+static size_t next_cached_texture;
+
+struct mag_geometry {
+	/* Area covered by the magnifier including its border */
+	struct wlr_box damage_box;
+	/* Area the magnified content is drawn to */
+	struct wlr_box dst_box;
+	/* Area of the output buffer which is magnified */
+	struct wlr_fbox src_box;
+	/* Size of the source area before clipping it to the output */
+	int src_width, src_height;
+};
+
+static void
+cached_texture_clear(struct cached_texture *cached)
+{
+	if (!cached->buffer) {
+		return;
+	}
+	wlr_texture_destroy(cached->texture);
+	wl_list_remove(&cached->buffer_destroy.link);
+	*cached = (struct cached_texture){0};
+}
+
+static void
+handle_buffer_destroy(struct wl_listener *listener, void *data)
+{
+	struct cached_texture *cached =
+		wl_container_of(listener, cached, buffer_destroy);
+	cached_texture_clear(cached);
+}
+
+static void
+clear_texture_cache(void)
+{
+	for (size_t i = 0; i < NR_CACHED_TEXTURES; i++) {
+		cached_texture_clear(&cached_textures[i]);
+	}
+}
+
+static struct wlr_texture *
+get_output_texture(struct wlr_renderer *renderer, struct wlr_buffer *buffer)
+{
+	for (size_t i = 0; i < NR_CACHED_TEXTURES; i++) {
+		if (cached_textures[i].buffer == buffer) {
+			return cached_textures[i].texture;
+		}
+	}
+
+	struct wlr_texture *texture = wlr_texture_from_buffer(renderer, buffer);
+	if (!texture) {
+		return NULL;
+	}
+
+	/* Evict the least recently added texture */
+	struct cached_texture *cached = &cached_textures[next_cached_texture];
+	next_cached_texture = (next_cached_texture + 1) % NR_CACHED_TEXTURES;
+	cached_texture_clear(cached);
+
+	cached->buffer = buffer;
+	cached->texture = texture;
+	cached->buffer_destroy.notify = handle_buffer_destroy;
+	wl_signal_add(&buffer->events.destroy, &cached->buffer_destroy);
+	return texture;
+}
+
 static void
 box_logical_to_physical(struct wlr_box *box, struct wlr_output *output)
 {
@@ -38,33 +118,58 @@ box_logical_to_physical(struct wlr_box *box, struct wlr_output *output)
 		output_w, output_h);
 }
 
-void
-magnifier_draw(struct output *output, struct wlr_buffer *output_buffer, struct wlr_box *damage)
+static bool
+fbox_intersection(struct wlr_fbox *dst, const struct wlr_fbox *a,
+		const struct wlr_fbox *b)
+{
+	double x1 = fmax(a->x, b->x);
+	double y1 = fmax(a->y, b->y);
+	double x2 = fmin(a->x + a->width, b->x + b->width);
+	double y2 = fmin(a->y + a->height, b->y + b->height);
+	*dst = (struct wlr_fbox){
+		.x = x1,
+		.y = y1,
+		.width = x2 - x1,
+		.height = y2 - y1,
+	};
+	return dst->width > 0 && dst->height > 0;
+}
+
+/*
+ * Computes where the magnifier is drawn on @output in physical pixels.
+ * Returns false if the magnifier is not shown on @output.
+ */
+static bool
+get_geometry(struct output *output, struct mag_geometry *geo)
 {
 	struct server *server = output->server;
-	struct theme *theme = server->theme;
+	struct wlr_output *wlr_output = output->wlr_output;
 	bool fullscreen = (rc.mag_width == -1 || rc.mag_height == -1);
 
+	if (!magnify_on || output_nearest_to_cursor(server) != output) {
+		return false;
+	}
+
 	struct wlr_box output_box = {
-		.width = output_buffer->width,
-		.height = output_buffer->height,
+		.width = wlr_output->width,
+		.height = wlr_output->height,
 	};
 
 	/* Cursor position in per-output logical coordinate */
 	double cursor_logical_x = server->seat.cursor->x;
 	double cursor_logical_y = server->seat.cursor->y;
 	wlr_output_layout_output_coords(server->output_layout,
-		output->wlr_output, &cursor_logical_x, &cursor_logical_y);
+		wlr_output, &cursor_logical_x, &cursor_logical_y);
 	/* Cursor position in per-output physical coordinate */
 	struct wlr_box cursor_pos = {
 		.x = cursor_logical_x,
 		.y = cursor_logical_y,
 	};
-	box_logical_to_physical(&cursor_pos, output->wlr_output);
+	box_logical_to_physical(&cursor_pos, wlr_output);
 
 	if (!wlr_box_contains_point(&output_box,
 			cursor_pos.x, cursor_pos.y)) {
-		return;
+		return false;
 	}
 
 	if (mag_scale == 0.0) {
@@ -74,19 +179,115 @@ magnifier_draw(struct output *output, struct wlr_buffer *output_buffer, struct w
 
 	/* Magnifier geometry in physical output coordinate */
 	struct wlr_box mag_box;
+	struct wlr_fbox src_box;
 	if (fullscreen) {
 		mag_box = output_box;
+		src_box = (struct wlr_fbox){
+			.x = cursor_pos.x - (cursor_pos.x / mag_scale),
+			.y = cursor_pos.y - (cursor_pos.y / mag_scale),
+			.width = mag_box.width / mag_scale,
+			.height = mag_box.height / mag_scale,
+		};
+		geo->damage_box = output_box;
 	} else {
 		mag_box.x = cursor_logical_x - (rc.mag_width / 2.0);
 		mag_box.y = cursor_logical_y - (rc.mag_height / 2.0);
 		mag_box.width = rc.mag_width;
 		mag_box.height = rc.mag_height;
-		box_logical_to_physical(&mag_box, output->wlr_output);
+		box_logical_to_physical(&mag_box, wlr_output);
+		/* The source area is centered within the magnifier */
+		src_box = (struct wlr_fbox){
+			.x = mag_box.x + mag_box.width
+				* (mag_scale - 1.0) / (2.0 * mag_scale),
+			.y = mag_box.y + mag_box.height
+				* (mag_scale - 1.0) / (2.0 * mag_scale),
+			.width = mag_box.width / mag_scale,
+			.height = mag_box.height / mag_scale,
+		};
+		int border_width =
+			server->theme->mag_border_width * wlr_output->scale;
+		struct wlr_box border_box = {
+			.x = mag_box.x - border_width,
+			.y = mag_box.y - border_width,
+			.width = mag_box.width + border_width * 2,
+			.height = mag_box.height + border_width * 2,
+		};
+		wlr_box_intersection(&geo->damage_box, &border_box, &output_box);
+	}
+
+	geo->src_width = ceil(src_box.width);
+	geo->src_height = ceil(src_box.height);
+
+	/* Only the part of the source area within the output is magnified */
+	struct wlr_fbox output_fbox = box_to_fbox(&output_box);
+	if (!fbox_intersection(&geo->src_box, &src_box, &output_fbox)) {
+		return false;
+	}
+	geo->dst_box = (struct wlr_box){
+		.x = mag_box.x + (geo->src_box.x - src_box.x) * mag_scale,
+		.y = mag_box.y + (geo->src_box.y - src_box.y) * mag_scale,
+		.width = geo->src_box.width * mag_scale,
+		.height = geo->src_box.height * mag_scale,
+	};
+	return true;
+}
+
+/* Copy the source area into the scratch buffer */
+static bool
+extract_source(struct server *server, struct wlr_buffer *output_buffer,
+		struct wlr_box *copy_box)
+{
+	struct wlr_texture *output_texture =
+		get_output_texture(server->renderer, output_buffer);
+	if (!output_texture) {
+		return false;
 	}
 
+	struct wlr_render_pass *pass = wlr_renderer_begin_buffer_pass(
+		server->renderer, tmp_buffer, NULL);
+	if (!pass) {
+		wlr_log(WLR_ERROR, "Failed to begin magnifier render pass");
+		return false;
+	}
+	wlr_render_pass_add_texture(pass, &(struct wlr_render_texture_options){
+		.texture = output_texture,
+		.src_box = box_to_fbox(copy_box),
+		.dst_box = {
+			.width = copy_box->width,
+			.height = copy_box->height,
+		},
+		.blend_mode = WLR_RENDER_BLEND_MODE_NONE,
+	});
+	if (!wlr_render_pass_submit(pass)) {
+		wlr_log(WLR_ERROR, "Failed to extract magnifier source region");
+		return false;
+	}
+	return true;
+}
+
+void
+magnifier_draw(struct output *output, struct wlr_buffer *output_buffer)
+{
+	struct server *server = output->server;
+	struct theme *theme = server->theme;
+
+	struct mag_geometry geo;
+	if (!get_geometry(output, &geo)) {
+		return;
+	}
+
+	/*
+	 * Only the source area, which is smaller than the magnifier by the
+	 * magnification factor, is copied. The scratch buffer is sized for
+	 * the unclipped source area (plus rounding) so that it doesn't need
+	 * to be reallocated as the cursor approaches the output edges.
+	 */
+	int tmp_width = geo.src_width + 1;
+	int tmp_height = geo.src_height + 1;
+
 	/* (Re)create the temporary buffer if required */
-	if (tmp_buffer && (tmp_buffer->width != mag_box.width
-			|| tmp_buffer->height != mag_box.height)) {
+	if (tmp_buffer && (tmp_buffer->width != tmp_width
+			|| tmp_buffer->height != tmp_height)) {
 		wlr_log(WLR_DEBUG, "tmp magnifier buffer size changed, dropping");
 		assert(tmp_texture);
 		wlr_texture_destroy(tmp_texture);
@@ -96,7 +297,7 @@ magnifier_draw(struct output *output, struct wlr_buffer *output_buffer, struct w
 	}
 	if (!tmp_buffer) {
 		tmp_buffer = wlr_allocator_create_buffer(
-			server->allocator, mag_box.width, mag_box.height,
+			server->allocator, tmp_width, tmp_height,
 			&output->wlr_output->swapchain->format);
 	}
 	if (!tmp_buffer) {
@@ -114,134 +315,139 @@ magnifier_draw(struct output *output, struct wlr_buffer *output_buffer, struct w
 		return;
 	}
 
-	/* Extract source region into temporary buffer */
-	struct wlr_render_pass *tmp_render_pass = wlr_renderer_begin_buffer_pass(
-		server->renderer, tmp_buffer, NULL);
-	if (!tmp_render_pass) {
-		wlr_log(WLR_ERROR, "Failed to begin magnifier render pass");
-		return;
-	}
+	/* Pixel aligned area containing the source area */
+	struct wlr_box copy_box = {
+		.x = floor(geo.src_box.x),
+		.y = floor(geo.src_box.y),
+	};
+	copy_box.width = MIN((int)ceil(geo.src_box.x + geo.src_box.width)
+		- copy_box.x, tmp_width);
+	copy_box.height = MIN((int)ceil(geo.src_box.y + geo.src_box.height)
+		- copy_box.y, tmp_height);
 
 	wlr_buffer_lock(output_buffer);
-	struct wlr_texture *output_texture = wlr_texture_from_buffer(
-		server->renderer, output_buffer);
-	if (!output_texture) {
-		goto cleanup;
-	}
-
-	struct wlr_box src_box_for_copy;
-	wlr_box_intersection(&src_box_for_copy, &mag_box, &output_box);
-
-	struct wlr_box dst_box_for_copy = src_box_for_copy;
-	dst_box_for_copy.x -= mag_box.x;
-	dst_box_for_copy.y -= mag_box.y;
-
-	struct wlr_render_texture_options opts = {
-		.texture = output_texture,
-		.src_box = box_to_fbox(&src_box_for_copy),
-		.dst_box = dst_box_for_copy,
-	};
-	wlr_render_pass_add_texture(tmp_render_pass, &opts);
-	if (!wlr_render_pass_submit(tmp_render_pass)) {
-		wlr_log(WLR_ERROR, "Failed to extract magnifier source region");
-		wlr_texture_destroy(output_texture);
+	if (!extract_source(server, output_buffer, &copy_box)) {
 		goto cleanup;
 	}
-	wlr_texture_destroy(output_texture);
 
 	/* Render to the output buffer itself */
-	tmp_render_pass = wlr_renderer_begin_buffer_pass(
+	struct wlr_render_pass *pass = wlr_renderer_begin_buffer_pass(
 		server->renderer, output_buffer, NULL);
-	if (!tmp_render_pass) {
+	if (!pass) {
 		wlr_log(WLR_ERROR, "Failed to begin second magnifier render pass");
 		goto cleanup;
 	}
 
-	struct wlr_box damage_box;
-	if (fullscreen) {
-		damage_box = output_box;
-	} else {
+	if (!wlr_box_equal(&geo.damage_box, &geo.dst_box)) {
 		/* Draw borders */
-		int border_width =
-			theme->mag_border_width * output->wlr_output->scale;
-		struct wlr_box border_box = {
-			.x = mag_box.x - border_width,
-			.y = mag_box.y - border_width,
-			.width = mag_box.width + border_width * 2,
-			.height = mag_box.height + border_width * 2,
-		};
-		struct wlr_render_rect_options bg_opts = {
-			.box = border_box,
+		wlr_render_pass_add_rect(pass, &(struct wlr_render_rect_options){
+			.box = geo.damage_box,
 			.color = (struct wlr_render_color) {
 				.r = theme->mag_border_color[0],
 				.g = theme->mag_border_color[1],
 				.b = theme->mag_border_color[2],
 				.a = theme->mag_border_color[3]
 			},
-			.clip = NULL,
-		};
-		wlr_render_pass_add_rect(tmp_render_pass, &bg_opts);
-		wlr_box_intersection(&damage_box, &border_box, &output_box);
-	}
-
-	struct wlr_fbox src_box_for_paste = {
-		.width = mag_box.width / mag_scale,
-		.height = mag_box.height / mag_scale,
-	};
-
-	if (fullscreen) {
-		src_box_for_paste.x = cursor_pos.x - (cursor_pos.x / mag_scale);
-		src_box_for_paste.y = cursor_pos.y - (cursor_pos.y / mag_scale);
-	} else {
-		src_box_for_paste.x =
-			mag_box.width * (mag_scale - 1.0) / (2.0 * mag_scale);
-		src_box_for_paste.y =
-			mag_box.height * (mag_scale - 1.0) / (2.0 * mag_scale);
+		});
 	}
 
 	/* Paste the magnified result back into the output buffer */
-	opts = (struct wlr_render_texture_options) {
+	wlr_render_pass_add_texture(pass, &(struct wlr_render_texture_options){
 		.texture = tmp_texture,
-		.src_box = src_box_for_paste,
-		.dst_box = mag_box,
+		.src_box = {
+			.x = geo.src_box.x - copy_box.x,
+			.y = geo.src_box.y - copy_box.y,
+			.width = geo.src_box.width,
+			.height = geo.src_box.height,
+		},
+		.dst_box = geo.dst_box,
 		.filter_mode = rc.mag_filter ? WLR_SCALE_FILTER_BILINEAR
 			: WLR_SCALE_FILTER_NEAREST,
-	};
-	wlr_render_pass_add_texture(tmp_render_pass, &opts);
-	if (!wlr_render_pass_submit(tmp_render_pass)) {
+	});
+	if (!wlr_render_pass_submit(pass)) {
 		wlr_log(WLR_ERROR, "Failed to submit magnifier render pass");
 		goto cleanup;
 	}
 
-	/* And finally mark the extra damage */
-	*damage = damage_box;
+	/* Remember what has been drawn over the scene */
+	output->magnifier_box = geo.damage_box;
+	output->magnifier_src = geo.src_box;
 cleanup:
 	wlr_buffer_unlock(output_buffer);
 }
 
+void
+magnifier_add_damage(struct output *output, pixman_region32_t *damage)
+{
+	/*
+	 * The scene has to restore what was covered by the magnifier in the
+	 * previous frame, and has to render what will be magnified now
+	 * before magnifier_draw() copies it.
+	 */
+	pixman_region32_union_rect(damage, damage,
+		output->magnifier_box.x, output->magnifier_box.y,
+		output->magnifier_box.width, output->magnifier_box.height);
+	output->magnifier_box = (struct wlr_box){0};
+
+	struct mag_geometry geo;
+	if (get_geometry(output, &geo)) {
+		pixman_region32_union_rect(damage, damage,
+			geo.damage_box.x, geo.damage_box.y,
+			geo.damage_box.width, geo.damage_box.height);
+	}
+}
+
+/*
+ * Hardware cursors are moved without rendering a frame, so software
+ * cursors are used while the magnifier is on. That way cursor motion
+ * causes a frame in which the magnifier can follow the cursor (and the
+ * cursor itself is magnified).
+ */
+static void
+update_cursor_lock(struct output *output)
+{
+	if (output->magnifier_cursor_locked != magnify_on) {
+		wlr_output_lock_software_cursors(output->wlr_output, magnify_on);
+		output->magnifier_cursor_locked = magnify_on;
+	}
+}
+
 bool
 output_wants_magnification(struct output *output)
 {
-	static double x = -1;
-	static double y = -1;
-	struct wlr_cursor *cursor = output->server->seat.cursor;
-	if (!magnify_on) {
-		x = -1;
-		y = -1;
-		return false;
-	}
-	if (cursor->x == x && cursor->y == y) {
-		return false;
+	update_cursor_lock(output);
+
+	struct mag_geometry geo;
+	if (!get_geometry(output, &geo)) {
+		/* Needs a frame if the magnifier has to be removed */
+		return !wlr_box_empty(&output->magnifier_box);
 	}
-	x = cursor->x;
-	y = cursor->y;
-	return output_nearest_to_cursor(output->server) == output;
+
+	/* Nothing to do unless the cursor or magnification changed */
+	struct wlr_fbox *src = &output->magnifier_src;
+	return !wlr_box_equal(&geo.damage_box, &output->magnifier_box)
+		|| geo.src_box.x != src->x || geo.src_box.y != src->y
+		|| geo.src_box.width != src->width
+		|| geo.src_box.height != src->height;
 }
 
 static void
 enable_magnifier(struct server *server, bool enable)
 {
 	magnify_on = enable;
+	if (!enable) {
+		/* Don't keep the output buffers alive */
+		clear_texture_cache();
+	}
+
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		update_cursor_lock(output);
+		if (!wlr_box_empty(&output->magnifier_box)) {
+			/* Remove or move the magnifier */
+			wlr_output_schedule_frame(output->wlr_output);
+		}
+	}
 	server->scene->WLR_PRIVATE.direct_scanout = enable ? false
 		: server->direct_scanout_enabled;
 }
@@ -288,6 +494,7 @@ magnifier_set_scale(struct server *server, enum magnify_dir dir)
 void
 magnifier_reset(void)
 {
+	clear_texture_cache();
 	if (tmp_texture && tmp_buffer) {
 		wlr_texture_destroy(tmp_texture);
 		wlr_buffer_drop(tmp_buffer);
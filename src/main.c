@@ -10,6 +10,7 @@
 #include "config/rcxml.h"
 #include "config/session.h"
 #include "labwc.h"
+#include "startup-profile.h"
 #include "theme.h"
 #include "translate.h"
 #include "menu/menu.h"
@@ -23,6 +24,7 @@ static const struct option long_options[] = {
 	{"exit", no_argument, NULL, 'e'},
 	{"help", no_argument, NULL, 'h'},
 	{"merge-config", no_argument, NULL, 'm'},
+	{"profile-startup", required_argument, NULL, 'p'},
 	{"reconfigure", no_argument, NULL, 'r'},
 	{"startup", required_argument, NULL, 's'},
 	{"session", required_argument, NULL, 'S'},
@@ -39,6 +41,8 @@ static const char labwc_usage[] =
 "  -e, --exit               Exit the compositor\n"
 "  -h, --help               Show help message and quit\n"
 "  -m, --merge-config       Merge user config files/theme in all XDG Base Dirs\n"
+"  -p, --profile-startup <file>\n"
+"                           Time startup phases and write a trace to <file>\n"
 "  -r, --reconfigure        Reload the compositor configuration\n"
 "  -s, --startup <command>  Run command on startup\n"
 "  -S, --session <command>  Run command on startup and terminate on exit\n"
@@ -143,7 +147,9 @@ idle_callback(void *data)
 		}
 	}
 
+	startup_profile_begin("autostart");
 	session_autostart_init(ctx->server);
+	startup_profile_end();
 	if (ctx->startup_cmd) {
 		spawn_async_no_shell(ctx->startup_cmd);
 	}
@@ -154,12 +160,13 @@ main(int argc, char *argv[])
 {
 	char *startup_cmd = NULL;
 	char *primary_client = NULL;
+	char *profile_path = getenv("LABWC_STARTUP_PROFILE");
 	enum wlr_log_importance verbosity = WLR_ERROR;
 
 	int c;
 	while (1) {
 		int index = 0;
-		c = getopt_long(argc, argv, "c:C:dehmrs:S:vV", long_options, &index);
+		c = getopt_long(argc, argv, "c:C:dehmp:rs:S:vV", long_options, &index);
 		if (c == -1) {
 			break;
 		}
@@ -179,6 +186,9 @@ main(int argc, char *argv[])
 		case 'm':
 			rc.merge_config = true;
 			break;
+		case 'p':
+			profile_path = optarg;
+			break;
 		case 'r':
 			send_signal_to_labwc_pid(SIGHUP);
 			exit(0);
@@ -203,12 +213,17 @@ main(int argc, char *argv[])
 		usage();
 	}
 
+	startup_profile_init(profile_path);
 	wlr_log_init(verbosity, NULL);
 
 	die_on_detecting_suid();
+	startup_profile_begin("fonts");
 	die_on_no_fonts();
+	startup_profile_end();
 
+	startup_profile_begin("session_environment_init");
 	session_environment_init();
+	startup_profile_end();
 
 #if HAVE_NLS
 	/* Initialize locale after setting env vars */
@@ -217,7 +232,9 @@ main(int argc, char *argv[])
 	textdomain(GETTEXT_PACKAGE);
 #endif
 
+	startup_profile_begin("rcxml_read");
 	rcxml_read(rc.config_file);
+	startup_profile_end();
 
 	/*
 	 * Set environment variable SARTWC_PID to the pid of the compositor
@@ -247,15 +264,23 @@ main(int argc, char *argv[])
 	increase_nofile_limit();
 
 	struct server server = { 0 };
+	startup_profile_begin("server_init");
 	server_init(&server);
+	startup_profile_end();
+	startup_profile_begin("server_start");
 	server_start(&server);
+	startup_profile_end();
 
 	struct theme theme = { 0 };
+	startup_profile_begin("theme_init");
 	theme_init(&theme, &server, rc.theme_name);
+	startup_profile_end();
 	rc.theme = &theme;
 	server.theme = &theme;
 
+	startup_profile_begin("menu_init");
 	menu_init(&server);
+	startup_profile_end();
 
 	/* Delay startup of applications until the event loop is ready */
 	struct idle_ctx idle_ctx = {
@@ -265,13 +290,17 @@ main(int argc, char *argv[])
 	};
 	wl_event_loop_add_idle(server.wl_event_loop, idle_callback, &idle_ctx);
 
+	/* Ended by startup_profile_report() once a frame has been rendered */
+	startup_profile_begin("event loop until first frame");
 	wl_display_run(server.wl_display);
+	startup_profile_report();
 
 	session_shutdown(&server);
 
 	menu_finish(&server);
 	theme_finish(&theme);
 	rcxml_finish();
+	rcxml_finish_snapshots();
 	font_finish();
 
 	server_finish(&server);
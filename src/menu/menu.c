@@ -36,8 +36,6 @@
 #define PIPEMENU_MAX_BUF_SIZE 1048576  /* 1 MiB */
 #define PIPEMENU_TIMEOUT_IN_MS 4000    /* 4 seconds */
 
-#define ICON_SIZE (rc.theme->menu_item_height - 2 * rc.theme->menu_items_padding_y)
-
 static bool waiting_for_pipe_menu;
 static struct menuitem *selected_item;
 
@@ -162,6 +160,12 @@ item_create(struct menu *menu, const char *text, const char *icon_name, bool sho
 	return menuitem;
 }
 
+int
+menu_get_icon_size(struct theme *theme)
+{
+	return theme->menu_item_height - 2 * theme->menu_items_padding_y;
+}
+
 static struct wlr_scene_tree *
 item_create_scene_for_state(struct menuitem *item, float *text_color,
 	float *bg_color)
@@ -173,7 +177,7 @@ item_create_scene_for_state(struct menuitem *item, float *text_color,
 	struct wlr_scene_tree *tree = wlr_scene_tree_create(item->tree);
 
 	int icon_width = 0;
-	int icon_size = ICON_SIZE;
+	int icon_size = menu_get_icon_size(theme);
 	if (item->parent->has_icons) {
 		icon_width = theme->menu_items_padding_x + icon_size;
 	}
@@ -429,7 +433,8 @@ menu_create_scene(struct menu *menu)
 	}
 
 	if (menu->has_icons) {
-		menu->size.width += theme->menu_items_padding_x + ICON_SIZE;
+		menu->size.width += theme->menu_items_padding_x
+			+ menu_get_icon_size(theme);
 	}
 	menu->size.width = MAX(menu->size.width, theme->menu_min_width);
 	menu->size.width = MIN(menu->size.width, theme->menu_max_width);
@@ -675,7 +680,6 @@ parse_buf(struct server *server, struct menu *parent, struct buf *buf)
 	fill_menu_children(server, parent, root);
 
 	xmlFreeDoc(d);
-	xmlCleanupParser();
 	return true;
 }
 
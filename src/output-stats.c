@@ -0,0 +1,365 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include "output-stats.h"
+#include <pixman.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wlr/render/wlr_renderer.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_layout.h>
+#include "common/buf.h"
+#include "common/macros.h"
+#include "common/time-helpers.h"
+#include "config/rcxml.h"
+#include "labwc.h"
+#include "output.h"
+#include "scaled-buffer/scaled-font-buffer.h"
+#include "theme.h"
+
+#define NSEC_PER_USEC 1000
+#define HUD_UPDATE_INTERVAL_MSEC 1000
+#define HUD_MARGIN 10
+/* GPU timers keep running for this long after the last IPC query */
+#define TIMER_QUERY_WINDOW_NSEC (60 * 1000000000ULL)
+
+/*
+ * Durations are bucketed by powers of two microseconds: bucket 0 counts
+ * values below 2us, bucket i values in [2^i, 2^(i+1)) and the last bucket
+ * everything from ~65ms.
+ */
+#define NR_DURATION_BUCKETS 17
+/* Damage is bucketed in steps of 10% */
+#define NR_DAMAGE_BUCKETS 11
+
+static struct {
+	bool enabled;
+	struct wl_event_source *timer;
+} hud;
+
+static struct {
+	/* Renderer which was probed for timer support */
+	struct wlr_renderer *renderer;
+	bool supported;
+	uint64_t last_query; /* nanoseconds, CLOCK_MONOTONIC */
+} render_timers;
+
+/* Avoids GPU timer queries unless somebody looks at the results */
+static bool
+want_render_timer(struct output *output)
+{
+	if (!hud.enabled && (!render_timers.last_query
+			|| time_now_nsec() - render_timers.last_query
+				> TIMER_QUERY_WINDOW_NSEC)) {
+		return false;
+	}
+
+	struct wlr_renderer *renderer = output->server->renderer;
+	if (render_timers.renderer != renderer) {
+		struct wlr_render_timer *timer = wlr_render_timer_create(renderer);
+		render_timers.renderer = renderer;
+		render_timers.supported = timer;
+		if (timer) {
+			wlr_render_timer_destroy(timer);
+		}
+	}
+	return render_timers.supported;
+}
+
+static void
+series_add(struct output_stats_series *series, uint32_t value)
+{
+	series->values[series->next] = value;
+	series->next = (series->next + 1) % OUTPUT_STATS_NR_SAMPLES;
+	series->count = MIN(series->count + 1, OUTPUT_STATS_NR_SAMPLES);
+}
+
+static int
+compare_values(const void *a, const void *b)
+{
+	uint32_t va = *(const uint32_t *)a;
+	uint32_t vb = *(const uint32_t *)b;
+	return (va > vb) - (va < vb);
+}
+
+/* Fills @sorted with the values of @series and returns their number */
+static size_t
+series_sort(struct output_stats_series *series, uint32_t *sorted)
+{
+	memcpy(sorted, series->values, series->count * sizeof(sorted[0]));
+	qsort(sorted, series->count, sizeof(sorted[0]), compare_values);
+	return series->count;
+}
+
+static uint32_t
+percentile(const uint32_t *sorted, size_t count, int percent)
+{
+	return count ? sorted[(count - 1) * percent / 100] : 0;
+}
+
+static void
+handle_present(struct wl_listener *listener, void *data)
+{
+	struct output_stats *stats =
+		wl_container_of(listener, stats, present);
+	struct wlr_output_event_present *event = data;
+
+	/* Ignore commits which did not render a frame */
+	if (event->commit_seq != stats->commit_seq || !stats->commit_time) {
+		return;
+	}
+	if (!event->presented) {
+		stats->nr_discarded++;
+		return;
+	}
+
+	uint64_t when = (uint64_t)event->when.tv_sec * 1000000000
+		+ event->when.tv_nsec;
+	uint64_t latency = when > stats->commit_time
+		? when - stats->commit_time : 0;
+	series_add(&stats->latency, latency / NSEC_PER_USEC);
+	if (event->refresh > 0 && latency > (uint64_t)event->refresh) {
+		stats->nr_missed++;
+	}
+}
+
+void
+output_stats_init(struct output *output)
+{
+	struct output_stats *stats = &output->stats;
+	stats->present.notify = handle_present;
+	wl_signal_add(&output->wlr_output->events.present, &stats->present);
+}
+
+void
+output_stats_finish(struct output *output)
+{
+	struct output_stats *stats = &output->stats;
+	if (stats->timer_pending) {
+		wlr_scene_timer_finish(&stats->timer);
+		stats->timer_pending = false;
+	}
+	if (stats->hud_tree) {
+		wlr_scene_node_destroy(&stats->hud_tree->node);
+		stats->hud_tree = NULL;
+	}
+	wl_list_remove(&stats->present.link);
+}
+
+struct wlr_scene_timer *
+output_stats_get_timer(struct output *output)
+{
+	struct output_stats *stats = &output->stats;
+	if (stats->timer_pending) {
+		int64_t duration = wlr_scene_timer_get_duration_ns(&stats->timer);
+		if (duration >= 0) {
+			series_add(&stats->render, duration / NSEC_PER_USEC);
+		}
+		wlr_scene_timer_finish(&stats->timer);
+		stats->timer_pending = false;
+	}
+	if (!want_render_timer(output)) {
+		return NULL;
+	}
+	stats->timer = (struct wlr_scene_timer){0};
+	stats->timer_pending = true;
+	return &stats->timer;
+}
+
+static uint32_t
+get_damage_permille(const struct wlr_output_state *state)
+{
+	if (!state->buffer || !(state->committed & WLR_OUTPUT_STATE_DAMAGE)) {
+		/* Without damage the whole buffer is considered damaged */
+		return 1000;
+	}
+	uint64_t total = (uint64_t)state->buffer->width * state->buffer->height;
+	if (!total) {
+		return 0;
+	}
+
+	int nr_rects;
+	const pixman_box32_t *rects = pixman_region32_rectangles(
+		(pixman_region32_t *)&state->damage, &nr_rects);
+	uint64_t area = 0;
+	for (int i = 0; i < nr_rects; i++) {
+		area += (uint64_t)(rects[i].x2 - rects[i].x1)
+			* (rects[i].y2 - rects[i].y1);
+	}
+	return MIN(area * 1000 / total, 1000);
+}
+
+void
+output_stats_add_frame(struct output *output,
+		const struct wlr_output_state *state, uint64_t duration)
+{
+	struct output_stats *stats = &output->stats;
+	if (!state->buffer) {
+		/* Not a rendered frame, e.g. only a gamma update */
+		return;
+	}
+	stats->nr_frames++;
+	series_add(&stats->commit, duration / NSEC_PER_USEC);
+	series_add(&stats->damage, get_damage_permille(state));
+
+	stats->commit_seq = output->wlr_output->commit_seq;
+	stats->commit_time = time_now_nsec();
+}
+
+static int
+get_duration_bucket(uint32_t usec)
+{
+	int bucket = 0;
+	while (usec >= 2 && bucket < NR_DURATION_BUCKETS - 1) {
+		usec >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+static void
+print_series(struct buf *buf, const char *name,
+		struct output_stats_series *series, bool is_damage)
+{
+	uint32_t sorted[OUTPUT_STATS_NR_SAMPLES];
+	size_t count = series_sort(series, sorted);
+
+	buf_add_fmt(buf, "%s count=%zu p50=%u p90=%u p99=%u max=%u hist=",
+		name, count, percentile(sorted, count, 50),
+		percentile(sorted, count, 90), percentile(sorted, count, 99),
+		count ? sorted[count - 1] : 0);
+
+	int nr_buckets = is_damage ? NR_DAMAGE_BUCKETS : NR_DURATION_BUCKETS;
+	uint32_t buckets[NR_DURATION_BUCKETS] = {0};
+	for (size_t i = 0; i < count; i++) {
+		int bucket = is_damage ? (int)sorted[i] / 100
+			: get_duration_bucket(sorted[i]);
+		buckets[bucket]++;
+	}
+	for (int i = 0; i < nr_buckets; i++) {
+		buf_add_fmt(buf, "%s%u", i ? "," : "", buckets[i]);
+	}
+	buf_add_char(buf, '\n');
+}
+
+void
+output_stats_print(struct server *server, struct buf *buf)
+{
+	render_timers.last_query = time_now_nsec();
+
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		struct output_stats *stats = &output->stats;
+		buf_add_fmt(buf, "output name=%s refresh_mhz=%d frames=%llu "
+			"missed=%llu discarded=%llu\n",
+			output->wlr_output->name, output->wlr_output->refresh,
+			(unsigned long long)stats->nr_frames,
+			(unsigned long long)stats->nr_missed,
+			(unsigned long long)stats->nr_discarded);
+		print_series(buf, "commit_usec", &stats->commit, false);
+		print_series(buf, "render_usec", &stats->render, false);
+		print_series(buf, "latency_usec", &stats->latency, false);
+		print_series(buf, "damage_permille", &stats->damage, true);
+	}
+	buf_add(buf, "END\n");
+}
+
+static void
+add_hud_line(struct output *output, struct buf *text, int *y)
+{
+	struct theme *theme = output->server->theme;
+	struct scaled_font_buffer *line =
+		scaled_font_buffer_create(output->stats.hud_tree);
+	if (!line) {
+		return;
+	}
+	scaled_font_buffer_update(line, text->data, -1, &rc.font_osd,
+		theme->osd_label_text_color, theme->osd_bg_color);
+	wlr_scene_node_set_position(&line->scene_buffer->node, 0, *y);
+	*y += line->height;
+	buf_clear(text);
+}
+
+static void
+add_hud_series(struct output *output, struct buf *text, int *y,
+		const char *name, struct output_stats_series *series)
+{
+	uint32_t sorted[OUTPUT_STATS_NR_SAMPLES];
+	size_t count = series_sort(series, sorted);
+	buf_add_fmt(text, " %s p50 %.2fms p99 %.2fms max %.2fms ", name,
+		percentile(sorted, count, 50) / 1000.0,
+		percentile(sorted, count, 99) / 1000.0,
+		(count ? sorted[count - 1] : 0) / 1000.0);
+	add_hud_line(output, text, y);
+}
+
+static void
+update_hud(struct output *output)
+{
+	struct server *server = output->server;
+	struct output_stats *stats = &output->stats;
+
+	if (stats->hud_tree) {
+		wlr_scene_node_destroy(&stats->hud_tree->node);
+	}
+	stats->hud_tree = wlr_scene_tree_create(&server->scene->tree);
+
+	struct wlr_box box;
+	wlr_output_layout_get_box(server->output_layout,
+		output->wlr_output, &box);
+	wlr_scene_node_set_position(&stats->hud_tree->node,
+		box.x + HUD_MARGIN, box.y + HUD_MARGIN);
+
+	struct buf text = BUF_INIT;
+	int y = 0;
+	buf_add_fmt(&text, " %s %.2fHz frames %llu missed %llu ",
+		output->wlr_output->name, output->wlr_output->refresh / 1000.0,
+		(unsigned long long)stats->nr_frames,
+		(unsigned long long)stats->nr_missed);
+	add_hud_line(output, &text, &y);
+	add_hud_series(output, &text, &y, "commit", &stats->commit);
+	add_hud_series(output, &text, &y, "render", &stats->render);
+	add_hud_series(output, &text, &y, "latency", &stats->latency);
+
+	uint32_t sorted[OUTPUT_STATS_NR_SAMPLES];
+	size_t count = series_sort(&stats->damage, sorted);
+	buf_add_fmt(&text, " damage p50 %u%% p99 %u%% ",
+		percentile(sorted, count, 50) / 10,
+		percentile(sorted, count, 99) / 10);
+	add_hud_line(output, &text, &y);
+	buf_reset(&text);
+}
+
+static int
+handle_hud_timer(void *data)
+{
+	struct server *server = data;
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (output_is_usable(output)) {
+			update_hud(output);
+		}
+	}
+	wl_event_source_timer_update(hud.timer, HUD_UPDATE_INTERVAL_MSEC);
+	return 0;
+}
+
+void
+output_stats_toggle_hud(struct server *server)
+{
+	hud.enabled = !hud.enabled;
+	if (hud.enabled) {
+		hud.timer = wl_event_loop_add_timer(server->wl_event_loop,
+			handle_hud_timer, server);
+		handle_hud_timer(server);
+		return;
+	}
+
+	wl_event_source_remove(hud.timer);
+	hud.timer = NULL;
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (output->stats.hud_tree) {
+			wlr_scene_node_destroy(&output->stats.hud_tree->node);
+			output->stats.hud_tree = NULL;
+		}
+	}
+}
@@ -28,13 +28,17 @@
 #include "config/rcxml.h"
 #include "labwc.h"
 #include "layers.h"
+#include "layout-transaction.h"
 #include "node.h"
 #include "output-state.h"
+#include "output-stats.h"
 #include "output-virtual.h"
 #include "protocols/cosmic-workspaces.h"
 #include "protocols/ext-workspace.h"
 #include "regions.h"
+#include "render-delay.h"
 #include "session-lock.h"
+#include "startup-profile.h"
 #include "view.h"
 #include "xwayland.h"
 
@@ -109,25 +113,26 @@ output_apply_gamma(struct output *output)
 	wlr_output_state_finish(&pending);
 }
 
-static void
-handle_output_frame(struct wl_listener *listener, void *data)
+static bool
+output_can_render(struct output *output)
 {
-	/*
-	 * This function is called every time an output is ready to display a
-	 * frame - which is typically at 60 Hz.
-	 */
-	struct output *output = wl_container_of(listener, output, frame);
 	if (!output_is_usable(output)) {
-		return;
+		return false;
 	}
 
 	/*
 	 * skip painting the session when it exists but is not active.
 	 */
 	if (output->server->session && !output->server->session->active) {
-		return;
+		return false;
 	}
 
+	return true;
+}
+
+static void
+output_commit(struct output *output)
+{
 	if (output->gamma_lut_changed) {
 		/*
 		 * We are not mixing the gamma state with
@@ -145,12 +150,71 @@ handle_output_frame(struct wl_listener *listener, void *data)
 
 		lab_wlr_scene_output_commit(scene_output, pending);
 	}
+	startup_profile_report();
+}
+
+static void
+output_render(struct output *output)
+{
+	/* Update live window switcher thumbnails before rendering */
+	cycle_osd_update_live(output->server);
+
+	/*
+	 * Outputs showing views resized together are not committed until
+	 * all of them have their new size. Frame done events are still
+	 * sent, since many clients only commit after a frame callback.
+	 */
+	if (!layout_transaction_is_holding(output)) {
+		output_commit(output);
+	}
 
 	struct timespec now = { 0 };
 	clock_gettime(CLOCK_MONOTONIC, &now);
 	wlr_scene_output_send_frame_done(output->scene_output, &now);
 }
 
+static int
+handle_render_timer(void *data)
+{
+	struct output *output = data;
+	output->render_pending = false;
+	if (output_can_render(output)) {
+		output_render(output);
+	}
+	return 0;
+}
+
+static void
+handle_output_frame(struct wl_listener *listener, void *data)
+{
+	/*
+	 * This function is called every time an output is ready to display a
+	 * frame - which is typically at 60 Hz.
+	 */
+	struct output *output = wl_container_of(listener, output, frame);
+	if (!output_can_render(output) || output->render_pending) {
+		return;
+	}
+
+	/*
+	 * Delaying the render until just before the next vblank allows
+	 * clients which commit late in the refresh cycle to still make it
+	 * into the frame. Tearing page-flips are presented immediately
+	 * anyway, so there is nothing to gain for them.
+	 */
+	int delay = 0;
+	if (!output->gamma_lut_changed
+			&& !output_get_tearing_allowance(output)) {
+		delay = render_delay_get_msec(output);
+	}
+	if (delay > 0) {
+		output->render_pending = true;
+		wl_event_source_timer_update(output->render_timer, delay);
+		return;
+	}
+	output_render(output);
+}
+
 static void
 handle_output_destroy(struct wl_listener *listener, void *data)
 {
@@ -166,6 +230,8 @@ handle_output_destroy(struct wl_listener *listener, void *data)
 	wl_list_remove(&output->frame.link);
 	wl_list_remove(&output->destroy.link);
 	wl_list_remove(&output->request_state.link);
+	wl_event_source_remove(output->render_timer);
+	output_stats_finish(output);
 	seat_output_layout_changed(seat);
 
 	for (size_t i = 0; i < ARRAY_SIZE(output->layer_tree); i++) {
@@ -526,6 +592,9 @@ handle_new_output(struct wl_listener *listener, void *data)
 	wl_signal_add(&wlr_output->events.destroy, &output->destroy);
 	output->frame.notify = handle_output_frame;
 	wl_signal_add(&wlr_output->events.frame, &output->frame);
+	output->render_timer = wl_event_loop_add_timer(server->wl_event_loop,
+		handle_render_timer, output);
+	output_stats_init(output);
 
 	output->request_state.notify = handle_output_request_state;
 	wl_signal_add(&wlr_output->events.request_state, &output->request_state);
@@ -888,6 +957,9 @@ do_output_layout_change(struct server *server)
 		}
 		output_update_for_layout_change(server);
 		seat_output_layout_changed(&server->seat);
+#if HAVE_XWAYLAND
+		xwayland_update_icon_sizes(server);
+#endif
 	}
 }
 
@@ -1089,7 +1161,7 @@ output_update_usable_area(struct output *output)
 #if HAVE_XWAYLAND
 		xwayland_update_workarea(output->server);
 #endif
-		desktop_arrange_all_views(output->server);
+		desktop_arrange_views_for_layout_change(output->server);
 	}
 }
 
@@ -1111,7 +1183,7 @@ output_update_all_usable_areas(struct server *server, bool layout_changed)
 #if HAVE_XWAYLAND
 		xwayland_update_workarea(server);
 #endif
-		desktop_arrange_all_views(server);
+		desktop_arrange_views_for_layout_change(server);
 	}
 }
 
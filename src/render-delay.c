@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include "render-delay.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <wlr/types/wlr_output.h>
+#include "common/macros.h"
+#include "config/rcxml.h"
+#include "labwc.h"
+#include "output.h"
+#include "view.h"
+#include "window-rules.h"
+
+#define NSEC_PER_MSEC 1000000ULL
+
+/* The automatic render time is this percentile of recent frames... */
+#define AUTO_PERCENTILE 95
+/* ...plus a margin to absorb the jitter of the event loop and timer */
+#define AUTO_MARGIN_NSEC (1 * NSEC_PER_MSEC)
+/* Render without delay until there are enough samples to go by */
+#define AUTO_MIN_SAMPLES 8
+
+static int
+compare_durations(const void *a, const void *b)
+{
+	uint64_t da = *(const uint64_t *)a;
+	uint64_t db = *(const uint64_t *)b;
+	return (da > db) - (da < db);
+}
+
+void
+render_delay_add_sample(struct output *output, uint64_t duration)
+{
+	struct render_delay *delay = &output->render_delay;
+	delay->samples[delay->next_sample] = duration;
+	delay->next_sample = (delay->next_sample + 1) % RENDER_DELAY_NR_SAMPLES;
+	delay->nr_samples = MIN(delay->nr_samples + 1, RENDER_DELAY_NR_SAMPLES);
+
+	uint64_t sorted[RENDER_DELAY_NR_SAMPLES];
+	memcpy(sorted, delay->samples, delay->nr_samples * sizeof(sorted[0]));
+	qsort(sorted, delay->nr_samples, sizeof(sorted[0]), compare_durations);
+	delay->render_time =
+		sorted[(delay->nr_samples - 1) * AUTO_PERCENTILE / 100];
+}
+
+/*
+ * A <renderDelay> entry naming the output takes precedence over one
+ * without an output attribute, which applies to all outputs.
+ */
+static struct render_delay_config *
+get_config(struct output *output)
+{
+	struct render_delay_config *fallback = NULL;
+	struct render_delay_config *config;
+	wl_list_for_each(config, &rc.render_delays, link) {
+		if (!config->output) {
+			fallback = config;
+		} else if (!strcasecmp(config->output, output->wlr_output->name)) {
+			return config;
+		}
+	}
+	return fallback;
+}
+
+int
+render_delay_get_msec(struct output *output)
+{
+	/* Nested and headless outputs may not have a fixed refresh rate */
+	int refresh = output->wlr_output->refresh; /* mHz */
+	if (refresh <= 0) {
+		return 0;
+	}
+
+	struct render_delay_config *config = get_config(output);
+	enum render_delay_mode mode = config ? config->mode : LAB_RENDER_DELAY_OFF;
+
+	struct view *view = output->server->active_view;
+	if (view && view->output == output) {
+		switch (window_rules_get_property(view, LAB_RULE_PROP_RENDER_DELAY)) {
+		case LAB_PROP_FALSE:
+			return 0;
+		case LAB_PROP_TRUE:
+			if (mode == LAB_RENDER_DELAY_OFF) {
+				mode = LAB_RENDER_DELAY_AUTO;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	uint64_t render_time;
+	switch (mode) {
+	case LAB_RENDER_DELAY_FIXED:
+		render_time = config->max_render_time * NSEC_PER_MSEC;
+		break;
+	case LAB_RENDER_DELAY_AUTO:
+		if (output->render_delay.nr_samples < AUTO_MIN_SAMPLES) {
+			return 0;
+		}
+		render_time = output->render_delay.render_time + AUTO_MARGIN_NSEC;
+		break;
+	default:
+		return 0;
+	}
+
+	uint64_t refresh_period = 1000 * 1000 * NSEC_PER_MSEC / refresh;
+	if (render_time >= refresh_period) {
+		return 0;
+	}
+	/* Round down so that we rather render a little early than late */
+	return (refresh_period - render_time) / NSEC_PER_MSEC;
+}
@@ -3,19 +3,109 @@
 #include "scaled-buffer/scaled-icon-buffer.h"
 #include <assert.h>
 #include <string.h>
+#include <wlr/util/box.h>
 #include <wlr/util/log.h>
 #include "buffer.h"
+#include "common/array.h"
+#include "common/macros.h"
 #include "common/mem.h"
 #include "common/string-helpers.h"
 #include "config.h"
 #include "config/rcxml.h"
+#include "cycle.h"
 #include "desktop-entry.h"
 #include "img/img.h"
+#include "labwc.h"
+#include "menu/menu.h"
 #include "node.h"
+#include "output.h"
 #include "scaled-buffer/scaled-buffer.h"
+#include "ssd.h"
+#include "theme.h"
 #include "view.h"
 #include "window-rules.h"
 
+static bool
+is_better_icon_size(int curr_dist, int best_dist)
+{
+	if ((curr_dist < 0 && best_dist > 0)
+			|| (curr_dist > 0 && best_dist < 0)) {
+		/* prefer too big icon over too small icon */
+		return curr_dist > 0;
+	}
+	return abs(curr_dist) < abs(best_dist);
+}
+
+int
+scaled_icon_buffer_choose_client_icon(const int *widths, int nr_widths,
+		int size)
+{
+	int best_dist = -INT_MAX;
+	int best = -1;
+
+	for (int i = 0; i < nr_widths; i++) {
+		int curr_dist = widths[i] - size;
+		if (is_better_icon_size(curr_dist, best_dist)) {
+			best_dist = curr_dist;
+			best = i;
+		}
+	}
+	return best;
+}
+
+/* Icons are square and fit within the size of the buffer */
+static int
+get_icon_size(int width, int height)
+{
+	return MIN(width, height);
+}
+
+static void
+add_icon_size(struct wl_array *sizes, int size)
+{
+	int *s;
+	wl_array_for_each(s, sizes) {
+		if (*s == size) {
+			return;
+		}
+	}
+	array_add(sizes, size);
+}
+
+void
+scaled_icon_buffer_get_window_icon_sizes(struct server *server,
+		struct wl_array *sizes)
+{
+	wl_array_release(sizes);
+	wl_array_init(sizes);
+
+#if HAVE_LIBSFDO
+	struct theme *theme = server->theme;
+
+	/* The sizes of all callers of scaled_icon_buffer_create() */
+	int icon_sizes[4];
+	struct wlr_box button_icon = ssd_get_window_icon_box(theme);
+	icon_sizes[0] = get_icon_size(button_icon.width, button_icon.height);
+	icon_sizes[1] = menu_get_icon_size(theme);
+	/* The overview always uses the thumbnail style */
+	icon_sizes[2] = theme->osd_window_switcher_thumbnail.item_icon_size;
+
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (!output_is_usable(output)) {
+			continue;
+		}
+		icon_sizes[3] = cycle_osd_classic_get_icon_size(output);
+		float scale = output->wlr_output->scale;
+		for (size_t i = 0; i < ARRAY_SIZE(icon_sizes); i++) {
+			if (icon_sizes[i] > 0) {
+				add_icon_size(sizes, (int)(icon_sizes[i] * scale));
+			}
+		}
+	}
+#endif /* HAVE_LIBSFDO */
+}
+
 #if HAVE_LIBSFDO
 
 static struct lab_data_buffer *
@@ -27,15 +117,7 @@ choose_best_icon_buffer(struct scaled_icon_buffer *self, int icon_size, double s
 	struct lab_data_buffer **buffer;
 	wl_array_for_each(buffer, &self->view_icon_buffers) {
 		int curr_dist = (*buffer)->base.width - (int)(icon_size * scale);
-		bool curr_is_better;
-		if ((curr_dist < 0 && best_dist > 0)
-				|| (curr_dist > 0 && best_dist < 0)) {
-			/* prefer too big icon over too small icon */
-			curr_is_better = curr_dist > 0;
-		} else {
-			curr_is_better = abs(curr_dist) < abs(best_dist);
-		}
-		if (curr_is_better) {
+		if (is_better_icon_size(curr_dist, best_dist)) {
 			best_dist = curr_dist;
 			best_buffer = *buffer;
 		}
@@ -100,7 +182,7 @@ _create_buffer(struct scaled_buffer *scaled_buffer, double scale)
 {
 #if HAVE_LIBSFDO
 	struct scaled_icon_buffer *self = scaled_buffer->data;
-	int icon_size = MIN(self->width, self->height);
+	int icon_size = get_icon_size(self->width, self->height);
 	struct lab_img *img = NULL;
 	struct lab_data_buffer *buffer = NULL;
 
@@ -266,7 +348,7 @@ handle_view_new_title(struct wl_listener *listener, void *data)
 		wl_container_of(listener, self, on_view.new_title);
 
 	bool prefer_client = window_rules_get_property(
-		self->view, "iconPreferClient") == LAB_PROP_TRUE;
+		self->view, LAB_RULE_PROP_ICON_PREFER_CLIENT) == LAB_PROP_TRUE;
 	if (prefer_client == self->view_icon_prefer_client) {
 		return;
 	}
@@ -288,7 +370,7 @@ handle_view_new_app_id(struct wl_listener *listener, void *data)
 
 	xstrdup_replace(self->view_app_id, app_id);
 	self->view_icon_prefer_client = window_rules_get_property(
-		self->view, "iconPreferClient") == LAB_PROP_TRUE;
+		self->view, LAB_RULE_PROP_ICON_PREFER_CLIENT) == LAB_PROP_TRUE;
 	scaled_buffer_request_update(self->scaled_buffer,
 		self->width, self->height);
 }
@@ -63,8 +63,11 @@
 #include "scaled-buffer/scaled-buffer.h"
 #include "session-lock.h"
 #include "ssd.h"
+#include "startup-profile.h"
 #include "theme.h"
+#include "thumbnail.h"
 #include "view.h"
+#include "window-rules.h"
 #include "workspaces.h"
 #include "xwayland.h"
 #include "ipc.h"
@@ -85,6 +88,7 @@ reload_config_and_theme(struct server *server)
 	scaled_buffer_invalidate_sharing();
 	rcxml_finish();
 	rcxml_read(rc.config_file);
+	window_rules_invalidate_all();
 	theme_finish(server->theme);
 	theme_init(server->theme, server, rc.theme_name);
 
@@ -105,6 +109,9 @@ reload_config_and_theme(struct server *server)
 	resize_indicator_reconfigure(server);
 	kde_server_decoration_update_default();
 	workspaces_reconfigure(server);
+#if HAVE_XWAYLAND
+	xwayland_update_icon_sizes(server);
+#endif
 }
 
 static int
@@ -418,6 +425,7 @@ handle_renderer_lost(struct wl_listener *listener, void *data)
 	reload_config_and_theme(server);
 
 	magnifier_reset();
+	thumbnail_reset(server);
 
 	wlr_allocator_destroy(old_allocator);
 	wlr_renderer_destroy(old_renderer);
@@ -464,8 +472,10 @@ server_init(struct server *server)
 	 * backend based on the current environment, such as opening an x11
 	 * window if an x11 server is running.
 	 */
+	startup_profile_begin("backend");
 	server->backend = wlr_backend_autocreate(
 		server->wl_event_loop, &server->session);
+	startup_profile_end();
 	if (!server->backend) {
 		wlr_log(WLR_ERROR, "unable to create backend");
 		fprintf(stderr, helpful_seat_error_message);
@@ -504,7 +514,9 @@ server_init(struct server *server)
 	 * The renderer is responsible for defining the various pixel formats it
 	 * supports for shared memory, this configures that for clients.
 	 */
+	startup_profile_begin("renderer");
 	server->renderer = wlr_renderer_autocreate(server->backend);
+	startup_profile_end();
 	if (!server->renderer) {
 		wlr_log(WLR_ERROR, "unable to create renderer");
 		exit(EXIT_FAILURE);
@@ -551,6 +563,7 @@ server_init(struct server *server)
 	}
 
 	wl_list_init(&server->views);
+	wl_list_init(&server->views_by_age);
 	wl_list_init(&server->unmanaged_surfaces);
 	wl_list_init(&server->cycle.views);
 	wl_list_init(&server->cycle.osd_outputs);
@@ -639,7 +652,9 @@ server_init(struct server *server)
 		server->wl_display);
 	server->text_input_manager = wlr_text_input_manager_v3_create(
 		server->wl_display);
+	startup_profile_begin("seat_init");
 	seat_init(server);
+	startup_profile_end();
 	xdg_shell_init(server);
 	kde_server_decoration_init(server);
 	xdg_server_decoration_init(server);
@@ -724,11 +739,15 @@ server_init(struct server *server)
 	wlr_xdg_foreign_v2_create(server->wl_display, registry);
 
 #if HAVE_LIBSFDO
+	startup_profile_begin("desktop_entry_init");
 	desktop_entry_init(server);
+	startup_profile_end();
 #endif
 
 #if HAVE_XWAYLAND
+	startup_profile_begin("xwayland_server_init");
 	xwayland_server_init(server, server->compositor);
+	startup_profile_end();
 #endif
 }
 
@@ -746,7 +765,10 @@ server_start(struct server *server)
 	 * Start the backend. This will enumerate outputs and inputs, become
 	 * the DRM master, etc
 	 */
-	if (!wlr_backend_start(server->backend)) {
+	startup_profile_begin("wlr_backend_start");
+	bool started = wlr_backend_start(server->backend);
+	startup_profile_end();
+	if (!started) {
 		wlr_log(WLR_ERROR, "unable to start the wlroots backend");
 		exit(EXIT_FAILURE);
 	}
@@ -10,6 +10,27 @@
 #include "scaled-buffer/scaled-img-buffer.h"
 #include "ssd.h"
 #include "ssd-internal.h"
+#include "theme.h"
+
+struct wlr_box
+ssd_get_window_icon_box(struct theme *theme)
+{
+	int button_width = theme->window_button_width;
+	/*
+	 * Ensure a small amount of horizontal padding within the button
+	 * area (2px on each side with the default 26px button width).
+	 * A new theme setting could be added to configure this. Using
+	 * an existing setting (padding.width or window.button.spacing)
+	 * was considered, but these settings have distinct purposes
+	 * already and are zero by default.
+	 */
+	int icon_padding = button_width / 10;
+	return (struct wlr_box){
+		.x = icon_padding,
+		.width = button_width - 2 * icon_padding,
+		.height = theme->window_button_height,
+	};
+}
 
 /* Internal API */
 
@@ -35,26 +56,15 @@ attach_ssd_button(struct wl_list *button_parts, enum lab_node_type type,
 		rc.theme->window_button_height, invisible);
 
 	/* Icons */
-	int button_width = rc.theme->window_button_width;
-	int button_height = rc.theme->window_button_height;
-	/*
-	 * Ensure a small amount of horizontal padding within the button
-	 * area (2px on each side with the default 26px button width).
-	 * A new theme setting could be added to configure this. Using
-	 * an existing setting (padding.width or window.button.spacing)
-	 * was considered, but these settings have distinct purposes
-	 * already and are zero by default.
-	 */
-	int icon_padding = button_width / 10;
-
 	if (type == LAB_NODE_BUTTON_WINDOW_ICON) {
+		struct wlr_box box = ssd_get_window_icon_box(rc.theme);
 		struct scaled_icon_buffer *icon_buffer =
 			scaled_icon_buffer_create(root, view->server,
-				button_width - 2 * icon_padding, button_height);
+				box.width, box.height);
 		assert(icon_buffer);
 		struct wlr_scene_node *icon_node = &icon_buffer->scene_buffer->node;
 		scaled_icon_buffer_set_view(icon_buffer, view);
-		wlr_scene_node_set_position(icon_node, icon_padding, 0);
+		wlr_scene_node_set_position(icon_node, box.x, box.y);
 		button->window_icon = icon_buffer;
 	} else {
 		for (uint8_t state_set = LAB_BS_DEFAULT;
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include "startup-profile.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <wayland-util.h>
+#include <wlr/util/log.h>
+#include "common/buf.h"
+#include "common/mem.h"
+#include "common/time-helpers.h"
+
+#define MAX_DEPTH 8
+#define NSEC_PER_MSEC 1000000.0
+#define NSEC_PER_USEC 1000.0
+
+struct startup_phase {
+	const char *name;
+	int parent; /* index into profile.phases or -1 */
+	uint64_t start;
+	uint64_t end;
+};
+
+static struct {
+	bool enabled;
+	char *trace_path;
+	uint64_t origin;
+	struct wl_array phases; /* struct startup_phase */
+	int stack[MAX_DEPTH];
+	int depth;
+} profile;
+
+static struct startup_phase *
+get_phase(int index)
+{
+	return (struct startup_phase *)profile.phases.data + index;
+}
+
+static int
+nr_phases(void)
+{
+	return profile.phases.size / sizeof(struct startup_phase);
+}
+
+void
+startup_profile_init(const char *trace_path)
+{
+	if (!trace_path || !*trace_path) {
+		return;
+	}
+	profile.enabled = true;
+	profile.trace_path = xstrdup(trace_path);
+	profile.origin = time_now_nsec();
+	wl_array_init(&profile.phases);
+}
+
+void
+startup_profile_begin(const char *name)
+{
+	if (!profile.enabled) {
+		return;
+	}
+	/* Phases nested too deeply are not recorded, only counted */
+	if (profile.depth < MAX_DEPTH) {
+		int index = nr_phases();
+		struct startup_phase *phase =
+			wl_array_add(&profile.phases, sizeof(*phase));
+		*phase = (struct startup_phase){
+			.name = name,
+			.parent = profile.depth
+				? profile.stack[profile.depth - 1] : -1,
+			.start = time_now_nsec(),
+		};
+		profile.stack[profile.depth] = index;
+	}
+	profile.depth++;
+}
+
+void
+startup_profile_end(void)
+{
+	if (!profile.enabled || !profile.depth) {
+		return;
+	}
+	profile.depth--;
+	if (profile.depth < MAX_DEPTH) {
+		get_phase(profile.stack[profile.depth])->end = time_now_nsec();
+	}
+}
+
+/* Adds "parent > child" to @buf for the phase at @index */
+static void
+add_phase_path(struct buf *buf, int index)
+{
+	struct startup_phase *phase = get_phase(index);
+	if (phase->parent >= 0) {
+		add_phase_path(buf, phase->parent);
+		buf_add(buf, " > ");
+	}
+	buf_add(buf, phase->name);
+}
+
+static int
+compare_durations(const void *a, const void *b)
+{
+	struct startup_phase *pa = get_phase(*(const int *)a);
+	struct startup_phase *pb = get_phase(*(const int *)b);
+	uint64_t da = pa->end - pa->start;
+	uint64_t db = pb->end - pb->start;
+	return (da < db) - (da > db);
+}
+
+static void
+print_summary(uint64_t total)
+{
+	int count = nr_phases();
+	int *sorted = znew_n(*sorted, count);
+	for (int i = 0; i < count; i++) {
+		sorted[i] = i;
+	}
+	qsort(sorted, count, sizeof(sorted[0]), compare_durations);
+
+	fprintf(stderr, "startup profile: %.3f ms until the first frame\n",
+		total / NSEC_PER_MSEC);
+	struct buf path = BUF_INIT;
+	for (int i = 0; i < count; i++) {
+		struct startup_phase *phase = get_phase(sorted[i]);
+		uint64_t duration = phase->end - phase->start;
+		buf_clear(&path);
+		add_phase_path(&path, sorted[i]);
+		fprintf(stderr, "%10.3f ms %5.1f%%  %s\n",
+			duration / NSEC_PER_MSEC,
+			total ? 100.0 * duration / total : 0.0, path.data);
+	}
+	buf_reset(&path);
+	free(sorted);
+}
+
+static void
+write_trace(uint64_t total)
+{
+	FILE *fp = fopen(profile.trace_path, "w");
+	if (!fp) {
+		wlr_log_errno(WLR_ERROR, "cannot write startup profile to %s",
+			profile.trace_path);
+		return;
+	}
+
+	int pid = getpid();
+	fprintf(fp, "{\"traceEvents\":[\n");
+	fprintf(fp, "{\"name\":\"startup\",\"ph\":\"X\",\"ts\":0,"
+		"\"dur\":%.3f,\"pid\":%d,\"tid\":%d}", total / NSEC_PER_USEC,
+		pid, pid);
+	for (int i = 0; i < nr_phases(); i++) {
+		struct startup_phase *phase = get_phase(i);
+		fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+			"\"dur\":%.3f,\"pid\":%d,\"tid\":%d}", phase->name,
+			(phase->start - profile.origin) / NSEC_PER_USEC,
+			(phase->end - phase->start) / NSEC_PER_USEC, pid, pid);
+	}
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+}
+
+void
+startup_profile_report(void)
+{
+	if (!profile.enabled) {
+		return;
+	}
+	while (profile.depth) {
+		startup_profile_end();
+	}
+
+	uint64_t total = time_now_nsec() - profile.origin;
+	print_summary(total);
+	write_trace(total);
+
+	wl_array_release(&profile.phases);
+	zfree(profile.trace_path);
+	profile.enabled = false;
+}
@@ -0,0 +1,405 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include "thumbnail.h"
+#include <math.h>
+#include <wlr/render/allocator.h>
+#include <wlr/render/swapchain.h>
+#include <wlr/render/wlr_texture.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/log.h>
+#include "common/box.h"
+#include "common/mem.h"
+#include "labwc.h"
+#include "output.h"
+#include "view.h"
+
+/* FNV-1a parameters, applied to 64-bit words rather than bytes */
+#define HASH_INIT 0xcbf29ce484222325ULL
+#define HASH_PRIME 0x100000001b3ULL
+
+/*
+ * Thumbnails of a view are shown at more than one size, for example in
+ * the window switcher and in the overview or on outputs with different
+ * scales, so a few sizes are cached to avoid re-rendering when switching
+ * between them.
+ */
+#define THUMBNAIL_MAX_SIZES 4
+
+struct thumbnail_entry {
+	/* In physical pixels, or NULL if the entry is unused */
+	struct wlr_buffer *buffer;
+	/*
+	 * Previous buffer of the same size, re-rendered next time rather
+	 * than the current one which may still be shown by the scene
+	 */
+	struct wlr_buffer *spare;
+	/* Identifies the view content the buffer was rendered from */
+	uint64_t content_hash;
+	/* Value of thumbnail.use_counter when the entry was last used */
+	uint64_t last_used;
+};
+
+struct thumbnail {
+	struct view *view;
+	struct thumbnail_entry entries[THUMBNAIL_MAX_SIZES];
+	uint64_t use_counter;
+	/* Content hash of the most recently requested thumbnail */
+	uint64_t content_hash;
+	struct wl_listener view_destroy;
+};
+
+struct render_context {
+	struct wlr_renderer *renderer;
+	struct wlr_render_pass *pass;
+	double scale_x, scale_y;
+};
+
+static void
+hash_mix(uint64_t *hash, uint64_t value)
+{
+	*hash ^= value;
+	*hash *= HASH_PRIME;
+}
+
+static uint64_t
+pack_coords(int a, int b)
+{
+	return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+}
+
+/*
+ * Computes a hash over everything in the scene-tree of a view which
+ * affects the rendered thumbnail. wlr_surface_state.seq is incremented
+ * on every commit, so this also covers (desynchronized) subsurfaces
+ * without having to listen to the commits of each of them.
+ */
+static void
+update_content_hash(struct wlr_scene_node *node, uint64_t *hash)
+{
+	switch (node->type) {
+	case WLR_SCENE_NODE_TREE: {
+		struct wlr_scene_tree *tree = wlr_scene_tree_from_node(node);
+		hash_mix(hash, pack_coords(node->x, node->y));
+		struct wlr_scene_node *child;
+		wl_list_for_each(child, &tree->children, link) {
+			update_content_hash(child, hash);
+		}
+		break;
+	}
+	case WLR_SCENE_NODE_BUFFER: {
+		struct wlr_scene_buffer *scene_buffer =
+			wlr_scene_buffer_from_node(node);
+		hash_mix(hash, (uintptr_t)scene_buffer->buffer);
+		hash_mix(hash, pack_coords(node->x, node->y));
+		hash_mix(hash, pack_coords(scene_buffer->dst_width,
+			scene_buffer->dst_height));
+		struct wlr_scene_surface *scene_surface =
+			wlr_scene_surface_try_from_buffer(scene_buffer);
+		if (scene_surface) {
+			hash_mix(hash, scene_surface->surface->current.seq);
+		}
+		break;
+	}
+	case WLR_SCENE_NODE_RECT:
+		break;
+	}
+}
+
+/*
+ * Returns a texture for the buffer of a scene node, preferring textures
+ * that already exist so that client buffers are not re-imported (dmabuf)
+ * or re-uploaded (shm) just for the thumbnail:
+ *
+ *  - Surface buffers are wlr_client_buffers which hold the texture that
+ *    was uploaded or imported when the client committed.
+ *  - Other buffers (e.g. server-side decorations) have usually been
+ *    rendered by the scene already, which keeps a texture around.
+ *
+ * Only if neither is available a new texture is created, in which case
+ * @owned is set and the caller must destroy the texture after use.
+ */
+static struct wlr_texture *
+get_texture(struct render_context *ctx, struct wlr_scene_buffer *scene_buffer,
+		bool *owned)
+{
+	struct wlr_client_buffer *client_buffer =
+		wlr_client_buffer_get(scene_buffer->buffer);
+	if (client_buffer && client_buffer->texture
+			&& client_buffer->texture->renderer == ctx->renderer) {
+		return client_buffer->texture;
+	}
+
+	struct wlr_texture *texture = scene_buffer->WLR_PRIVATE.texture;
+	if (texture && texture->renderer == ctx->renderer) {
+		return texture;
+	}
+
+	*owned = true;
+	return wlr_texture_from_buffer(ctx->renderer, scene_buffer->buffer);
+}
+
+static uint64_t
+get_content_hash(struct view *view)
+{
+	uint64_t content_hash = HASH_INIT;
+	update_content_hash(&view->content_tree->node, &content_hash);
+	return content_hash;
+}
+
+static void
+render_node(struct render_context *ctx, struct wlr_scene_node *node,
+		int x, int y)
+{
+	switch (node->type) {
+	case WLR_SCENE_NODE_TREE: {
+		struct wlr_scene_tree *tree = wlr_scene_tree_from_node(node);
+		struct wlr_scene_node *child;
+		wl_list_for_each(child, &tree->children, link) {
+			render_node(ctx, child, x + node->x, y + node->y);
+		}
+		break;
+	}
+	case WLR_SCENE_NODE_BUFFER: {
+		struct wlr_scene_buffer *scene_buffer =
+			wlr_scene_buffer_from_node(node);
+		if (!scene_buffer->buffer) {
+			break;
+		}
+		bool owned = false;
+		struct wlr_texture *texture = get_texture(ctx, scene_buffer,
+			&owned);
+		if (!texture) {
+			break;
+		}
+		/* Round the edges rather than the size to avoid gaps */
+		int x1 = lround(x * ctx->scale_x);
+		int y1 = lround(y * ctx->scale_y);
+		int x2 = lround((x + scene_buffer->dst_width) * ctx->scale_x);
+		int y2 = lround((y + scene_buffer->dst_height) * ctx->scale_y);
+		wlr_render_pass_add_texture(ctx->pass, &(struct wlr_render_texture_options){
+			.texture = texture,
+			.src_box = scene_buffer->src_box,
+			.dst_box = {
+				.x = x1,
+				.y = y1,
+				.width = x2 - x1,
+				.height = y2 - y1,
+			},
+			.transform = scene_buffer->transform,
+			.filter_mode = WLR_SCALE_FILTER_BILINEAR,
+		});
+		if (owned) {
+			wlr_texture_destroy(texture);
+		}
+		break;
+	}
+	case WLR_SCENE_NODE_RECT:
+		/* should be unreached */
+		wlr_log(WLR_ERROR, "ignoring rect");
+		break;
+	}
+}
+
+static bool
+render_thumb(struct server *server, struct wlr_buffer *buffer,
+		struct view *view)
+{
+	struct wlr_render_pass *pass = wlr_renderer_begin_buffer_pass(
+		server->renderer, buffer, NULL);
+	if (!pass) {
+		wlr_log(WLR_ERROR, "failed to begin thumbnail render pass");
+		return false;
+	}
+
+	/* The buffer is reused, so clear what was rendered before */
+	wlr_render_pass_add_rect(pass, &(struct wlr_render_rect_options){
+		.box = {
+			.width = buffer->width,
+			.height = buffer->height,
+		},
+		.blend_mode = WLR_RENDER_BLEND_MODE_NONE,
+	});
+
+	struct render_context ctx = {
+		.renderer = server->renderer,
+		.pass = pass,
+		.scale_x = (double)buffer->width / view->current.width,
+		.scale_y = (double)buffer->height / view->current.height,
+	};
+	render_node(&ctx, &view->content_tree->node, 0, 0);
+
+	if (!wlr_render_pass_submit(pass)) {
+		wlr_log(WLR_ERROR, "failed to submit render pass");
+		return false;
+	}
+	return true;
+}
+
+static void
+entry_finish(struct thumbnail_entry *entry)
+{
+	if (entry->buffer) {
+		wlr_buffer_drop(entry->buffer);
+	}
+	if (entry->spare) {
+		wlr_buffer_drop(entry->spare);
+	}
+	*entry = (struct thumbnail_entry){0};
+}
+
+static void
+thumbnail_destroy(struct thumbnail *thumb)
+{
+	for (int i = 0; i < THUMBNAIL_MAX_SIZES; i++) {
+		entry_finish(&thumb->entries[i]);
+	}
+	wl_list_remove(&thumb->view_destroy.link);
+	thumb->view->thumbnail = NULL;
+	free(thumb);
+}
+
+static void
+handle_view_destroy(struct wl_listener *listener, void *data)
+{
+	struct thumbnail *thumb =
+		wl_container_of(listener, thumb, view_destroy);
+	thumbnail_destroy(thumb);
+}
+
+static struct thumbnail *
+thumbnail_create(struct view *view)
+{
+	struct thumbnail *thumb = znew(*thumb);
+	thumb->view = view;
+	thumb->view_destroy.notify = handle_view_destroy;
+	wl_signal_add(&view->events.destroy, &thumb->view_destroy);
+	view->thumbnail = thumb;
+	return thumb;
+}
+
+/*
+ * Returns the entry caching a buffer of the given size or, if there is
+ * none, an unused entry or else the least recently used one, cleared.
+ */
+static struct thumbnail_entry *
+get_entry(struct thumbnail *thumb, int width, int height)
+{
+	struct thumbnail_entry *victim = &thumb->entries[0];
+	for (int i = 0; i < THUMBNAIL_MAX_SIZES; i++) {
+		struct thumbnail_entry *entry = &thumb->entries[i];
+		if (entry->buffer && entry->buffer->width == width
+				&& entry->buffer->height == height) {
+			return entry;
+		}
+		if (!victim->buffer) {
+			continue;
+		}
+		if (!entry->buffer || entry->last_used < victim->last_used) {
+			victim = entry;
+		}
+	}
+	entry_finish(victim);
+	return victim;
+}
+
+struct wlr_buffer *
+thumbnail_get(struct output *output, struct view *view,
+		int max_width, int max_height)
+{
+	if (!view->content_tree || wlr_box_empty(&view->current)) {
+		/*
+		 * Defensive. Could possibly occur if view was unmapped
+		 * with OSD already displayed.
+		 */
+		return NULL;
+	}
+
+	/*
+	 * Render in physical pixels of the output so that the thumbnail is
+	 * displayed 1:1 without any further scaling by the scene renderer.
+	 */
+	float scale = output->wlr_output->scale;
+	struct wlr_box bounds = {
+		.width = max_width * scale,
+		.height = max_height * scale,
+	};
+	struct wlr_box box = box_fit_within(view->current.width * scale,
+		view->current.height * scale, &bounds);
+	if (wlr_box_empty(&box)) {
+		return NULL;
+	}
+
+	struct thumbnail *thumb = view->thumbnail;
+	if (!thumb) {
+		thumb = thumbnail_create(view);
+	}
+
+	uint64_t content_hash = get_content_hash(view);
+
+	struct thumbnail_entry *entry = get_entry(thumb, box.width, box.height);
+	entry->last_used = ++thumb->use_counter;
+	if (entry->buffer && entry->content_hash == content_hash) {
+		/* Nothing changed since the last capture */
+		thumb->content_hash = content_hash;
+		return entry->buffer;
+	}
+
+	/*
+	 * Never render into a buffer which is still locked, for example
+	 * by a scene-buffer that has not been given the new one yet.
+	 */
+	struct wlr_buffer *buffer = entry->spare;
+	entry->spare = NULL;
+	if (buffer && buffer->n_locks) {
+		wlr_buffer_drop(buffer);
+		buffer = NULL;
+	}
+
+	struct server *server = output->server;
+	if (!buffer) {
+		buffer = wlr_allocator_create_buffer(server->allocator,
+			box.width, box.height,
+			&output->wlr_output->swapchain->format);
+		if (!buffer) {
+			wlr_log(WLR_ERROR, "failed to allocate thumbnail buffer");
+			return NULL;
+		}
+	}
+
+	if (!render_thumb(server, buffer, view)) {
+		wlr_buffer_drop(buffer);
+		entry_finish(entry);
+		return NULL;
+	}
+	entry->spare = entry->buffer;
+	entry->buffer = buffer;
+	entry->content_hash = content_hash;
+	thumb->content_hash = content_hash;
+	return entry->buffer;
+}
+
+bool
+thumbnail_is_outdated(struct view *view)
+{
+	if (!view->content_tree) {
+		/* Nothing to render */
+		return false;
+	}
+	struct thumbnail *thumb = view->thumbnail;
+	if (!thumb || !thumb->use_counter) {
+		return true;
+	}
+	return get_content_hash(view) != thumb->content_hash;
+}
+
+void
+thumbnail_reset(struct server *server)
+{
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (view->thumbnail) {
+			thumbnail_destroy(view->thumbnail);
+		}
+	}
+}
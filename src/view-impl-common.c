@@ -4,6 +4,7 @@
 #include "foreign-toplevel/foreign.h"
 #include "ipc.h"
 #include "labwc.h"
+#include "layout-transaction.h"
 #include "view.h"
 #include "window-rules.h"
 
@@ -27,7 +28,7 @@ view_impl_map(struct view *view)
 	 * etc.) as these should not be shown in taskbars/docks/etc.
 	 */
 	if (!view->foreign_toplevel && view_is_focusable(view)
-			&& window_rules_get_property(view, "skipTaskbar")
+			&& window_rules_get_property(view, LAB_RULE_PROP_SKIP_TASKBAR)
 				!= LAB_PROP_TRUE) {
 		view->foreign_toplevel = foreign_toplevel_create(view);
 
@@ -47,6 +48,7 @@ void
 view_impl_unmap(struct view *view)
 {
 	view_update_visibility(view);
+	layout_transaction_view_ready(view);
 
 	/*
 	 * When exiting an xwayland application with multiple views
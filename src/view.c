@@ -20,6 +20,7 @@
 #include "foreign-toplevel/foreign.h"
 #include "input/keyboard.h"
 #include "labwc.h"
+#include "layout-transaction.h"
 #include "menu/menu.h"
 #include "output.h"
 #include "placement.h"
@@ -293,7 +294,8 @@ matches_criteria(struct view *view, enum lab_view_criteria criteria)
 		}
 	}
 	if (criteria & LAB_VIEW_CRITERIA_NO_SKIP_WINDOW_SWITCHER) {
-		if (window_rules_get_property(view, "skipWindowSwitcher") == LAB_PROP_TRUE) {
+		if (window_rules_get_property(view,
+				LAB_RULE_PROP_SKIP_WINDOW_SWITCHER) == LAB_PROP_TRUE) {
 			return false;
 		}
 	}
@@ -321,6 +323,23 @@ view_next(struct wl_list *head, struct view *view, enum lab_view_criteria criter
 	return NULL;
 }
 
+struct view *
+view_next_by_age(struct wl_list *head, struct view *view,
+		enum lab_view_criteria criteria)
+{
+	assert(head);
+
+	struct wl_list *elm = view ? &view->age_link : head;
+
+	for (elm = elm->next; elm != head; elm = elm->next) {
+		view = wl_container_of(elm, view, age_link);
+		if (matches_criteria(view, criteria)) {
+			return view;
+		}
+	}
+	return NULL;
+}
+
 struct view *
 view_prev(struct wl_list *head, struct view *view, enum lab_view_criteria criteria)
 {
@@ -506,7 +525,7 @@ view_close(struct view *view)
 	}
 }
 
-static void
+void
 view_update_outputs(struct view *view)
 {
 	struct output *output;
@@ -862,7 +881,8 @@ adjust_floating_geometry(struct view *view, struct wlr_box *geometry,
 	}
 
 	/* Avoid moving panels out of their own reserved area ("strut") */
-	if (window_rules_get_property(view, "fixedPosition") == LAB_PROP_TRUE
+	if (window_rules_get_property(view, LAB_RULE_PROP_FIXED_POSITION)
+				== LAB_PROP_TRUE
 			|| view_has_strut_partial(view)) {
 		return false;
 	}
@@ -1485,7 +1505,7 @@ bool
 view_wants_decorations(struct view *view)
 {
 	/* Window-rules take priority if they exist for this view */
-	switch (window_rules_get_property(view, "serverDecoration")) {
+	switch (window_rules_get_property(view, LAB_RULE_PROP_SERVER_DECORATION)) {
 	case LAB_PROP_TRUE:
 		return true;
 	case LAB_PROP_FALSE:
@@ -2288,6 +2308,7 @@ view_set_title(struct view *view, const char *title)
 		return;
 	}
 	xstrdup_replace(view->title, title);
+	window_rules_invalidate(view);
 
 	ssd_update_title(view->ssd);
 	wl_signal_emit_mutable(&view->events.new_title, NULL);
@@ -2305,6 +2326,7 @@ view_set_app_id(struct view *view, const char *app_id)
 		return;
 	}
 	xstrdup_replace(view->app_id, app_id);
+	window_rules_invalidate(view);
 
 	wl_signal_emit_mutable(&view->events.new_app_id, NULL);
 }
@@ -2471,6 +2493,7 @@ view_init(struct view *view)
 
 	view->title = xstrdup("");
 	view->app_id = xstrdup("");
+	window_rules_invalidate(view);
 }
 
 void
@@ -2481,6 +2504,7 @@ view_destroy(struct view *view)
 
 	wl_signal_emit_mutable(&view->events.destroy, NULL);
 	snap_constraints_invalidate(view);
+	layout_transaction_view_ready(view);
 
 	if (view->mappable.connected) {
 		mappable_disconnect(&view->mappable);
@@ -2551,8 +2575,10 @@ view_destroy(struct view *view)
 	assert(wl_list_empty(&view->events.set_icon.listener_list));
 	assert(wl_list_empty(&view->events.destroy.listener_list));
 
-	/* Remove view from server->views */
+	/* Remove view from server->views and server->views_by_age */
 	wl_list_remove(&view->link);
+	wl_list_remove(&view->age_link);
+	window_rules_invalidate(view);
 	free(view);
 
 	cursor_update_focus(server);
@@ -2,33 +2,144 @@
 #define _POSIX_C_SOURCE 200809L
 #include "window-rules.h"
 #include <assert.h>
+#include <glib.h>
 #include <stdbool.h>
-#include <strings.h>
 #include "action.h"
+#include "common/array.h"
+#include "common/match.h"
+#include "common/mem.h"
 #include "config/rcxml.h"
 #include "labwc.h"
 #include "view.h"
 
-static bool
-other_instances_exist(struct view *self, struct view_query *query)
+/*
+ * Index of the window rules by identifier. Rules with a literal
+ * identifier can only match views with that app_id, so looking up the
+ * app_id yields all candidate rules together with the remaining rules
+ * whose identifier is a pattern or not set at all.
+ */
+static struct {
+	/* Case-folded literal identifier -> struct wl_array of rules */
+	GHashTable *by_identifier;
+	/* Rules without a literal identifier */
+	struct wl_array generic;
+	/* Set if any rule has matchOnce="true" */
+	bool has_match_once;
+	bool valid;
+} rule_index;
+
+static guint
+hash_casefold(gconstpointer key)
 {
-	struct wl_list *views = &self->server->views;
-	struct view *view;
+	guint hash = 5381;
+	for (const char *p = key; *p; p++) {
+		hash = hash * 33 + g_ascii_tolower(*p);
+	}
+	return hash;
+}
 
-	wl_list_for_each(view, views, link) {
-		if (view != self && view_matches_query(view, query)) {
-			return true;
+static gboolean
+equal_casefold(gconstpointer a, gconstpointer b)
+{
+	return !g_ascii_strcasecmp(a, b);
+}
+
+static void
+free_rule_array(gpointer data)
+{
+	struct wl_array *rules = data;
+	wl_array_release(rules);
+	free(rules);
+}
+
+static void
+build_index(void)
+{
+	rule_index.by_identifier = g_hash_table_new_full(hash_casefold,
+		equal_casefold, NULL, free_rule_array);
+	wl_array_init(&rule_index.generic);
+	rule_index.has_match_once = false;
+
+	int index = 0;
+	struct window_rule *rule;
+	wl_list_for_each(rule, &rc.window_rules, link) {
+		rule->index = index++;
+		if (rule->match_once) {
+			rule_index.has_match_once = true;
+		}
+
+		struct wl_array *rules = &rule_index.generic;
+		if (rule->identifier_pattern.type == LAB_MATCH_LITERAL) {
+			const char *key = rule->identifier_pattern.str;
+			rules = g_hash_table_lookup(rule_index.by_identifier, key);
+			if (!rules) {
+				rules = znew(*rules);
+				wl_array_init(rules);
+				g_hash_table_insert(rule_index.by_identifier,
+					(gpointer)key, rules);
+			}
+		}
+		array_add(rules, rule);
+	}
+	rule_index.valid = true;
+}
+
+static void
+reset_index(void)
+{
+	if (!rule_index.valid) {
+		return;
+	}
+	g_hash_table_destroy(rule_index.by_identifier);
+	rule_index.by_identifier = NULL;
+	wl_array_release(&rule_index.generic);
+	rule_index.valid = false;
+}
+
+/*
+ * Fills @candidates with the rules that may match @view, in the order
+ * of rc.window_rules. The array must be released by the caller.
+ */
+static void
+get_candidate_rules(struct view *view, struct wl_array *candidates)
+{
+	if (!rule_index.valid) {
+		build_index();
+	}
+	wl_array_init(candidates);
+
+	struct wl_array empty = {0};
+	struct wl_array *literal =
+		g_hash_table_lookup(rule_index.by_identifier, view->app_id);
+	if (!literal) {
+		literal = &empty;
+	}
+
+	/* Merge both lists, which are each ordered by rule index */
+	struct window_rule **a = literal->data;
+	struct window_rule **b = rule_index.generic.data;
+	size_t len_a = literal->size / sizeof(*a);
+	size_t len_b = rule_index.generic.size / sizeof(*b);
+	size_t i = 0, j = 0;
+	while (i < len_a || j < len_b) {
+		if (j == len_b || (i < len_a && a[i]->index < b[j]->index)) {
+			array_add(candidates, a[i++]);
+		} else {
+			array_add(candidates, b[j++]);
 		}
 	}
-	return false;
 }
 
 static bool
-view_matches_criteria(struct window_rule *rule, struct view *view)
+rule_matches_view(struct window_rule *rule, struct view *view)
 {
+	if (!match_pattern_test(&rule->identifier_pattern, view->app_id)
+			|| !match_pattern_test(&rule->title_pattern, view->title)) {
+		return false;
+	}
+
+	/* identifier and title have been matched above */
 	struct view_query query = {
-		.identifier = rule->identifier,
-		.title = rule->title,
 		.window_type = rule->window_type,
 		.sandbox_engine = rule->sandbox_engine,
 		.sandbox_app_id = rule->sandbox_app_id,
@@ -36,32 +147,73 @@ view_matches_criteria(struct window_rule *rule, struct view *view)
 		.maximized = VIEW_AXIS_INVALID,
 		.decoration = LAB_SSD_MODE_INVALID,
 	};
+	return view_matches_query(view, &query);
+}
+
+static bool
+other_instances_exist(struct view *self, struct window_rule *rule)
+{
+	struct wl_list *views = &self->server->views;
+	struct view *view;
+
+	wl_list_for_each(view, views, link) {
+		if (view != self && rule_matches_view(rule, view)) {
+			return true;
+		}
+	}
+	return false;
+}
 
-	if (rule->match_once && other_instances_exist(view, &query)) {
+static bool
+view_matches_criteria(struct window_rule *rule, struct view *view)
+{
+	if (rule->match_once && other_instances_exist(view, rule)) {
 		return false;
 	}
 
-	return view_matches_query(view, &query);
+	return rule_matches_view(rule, view);
 }
 
 void
 window_rules_apply(struct view *view, enum window_rule_event event)
 {
-	struct window_rule *rule;
-	wl_list_for_each(rule, &rc.window_rules, link) {
-		if (rule->event != event) {
+	struct wl_array candidates;
+	get_candidate_rules(view, &candidates);
+
+	struct window_rule **rule;
+	wl_array_for_each(rule, &candidates) {
+		if ((*rule)->event != event) {
 			continue;
 		}
-		if (view_matches_criteria(rule, view)) {
-			actions_run(view, view->server, &rule->actions, NULL);
+		if (view_matches_criteria(*rule, view)) {
+			actions_run(view, view->server, &(*rule)->actions, NULL);
 		}
 	}
+	wl_array_release(&candidates);
 }
 
-enum property
-window_rules_get_property(struct view *view, const char *property)
+/*
+ * Bumped whenever the resolved properties of all views become stale.
+ * Views whose cache has a different generation resolve them again.
+ */
+static uint32_t generation = 1;
+
+static void
+bump_generation(void)
+{
+	/* Skip 0 on wrap-around, which marks unresolved caches */
+	if (!++generation) {
+		generation = 1;
+	}
+}
+
+static void
+resolve_properties(struct view *view)
 {
-	assert(property);
+	struct window_rule_cache *cache = &view->rule_cache;
+	for (int i = 0; i < LAB_RULE_PROP_COUNT; i++) {
+		cache->properties[i] = LAB_PROP_UNSPECIFIED;
+	}
 
 	/*
 	 * We iterate in reverse here because later items in list have higher
@@ -73,44 +225,57 @@ window_rules_get_property(struct view *view, const char *property)
 	 *       <windowRule identifier="foot" serverDecoration="default"/>
 	 *     </windowRules>
 	 */
-	struct window_rule *rule;
-	wl_list_for_each_reverse(rule, &rc.window_rules, link) {
+	struct wl_array candidates;
+	get_candidate_rules(view, &candidates);
+
+	struct window_rule **rule;
+	wl_array_for_each_reverse(rule, &candidates) {
+		if (!view_matches_criteria(*rule, view)) {
+			continue;
+		}
 		/*
-		 * Only return if property != LAB_PROP_UNSPECIFIED otherwise a
+		 * Only take properties != LAB_PROP_UNSPECIFIED, otherwise a
 		 * <windowRule> which does not set a particular property
-		 * attribute would still return here if that property was asked
-		 * for.
+		 * attribute would still override rules before it.
 		 */
-		if (view_matches_criteria(rule, view)) {
-			if (rule->server_decoration
-					&& !strcasecmp(property, "serverDecoration")) {
-				return rule->server_decoration;
-			}
-			if (rule->skip_taskbar
-					&& !strcasecmp(property, "skipTaskbar")) {
-				return rule->skip_taskbar;
-			}
-			if (rule->skip_window_switcher
-					&& !strcasecmp(property, "skipWindowSwitcher")) {
-				return rule->skip_window_switcher;
-			}
-			if (rule->ignore_focus_request
-					&& !strcasecmp(property, "ignoreFocusRequest")) {
-				return rule->ignore_focus_request;
-			}
-			if (rule->ignore_configure_request
-					&& !strcasecmp(property, "ignoreConfigureRequest")) {
-				return rule->ignore_configure_request;
-			}
-			if (rule->fixed_position
-					&& !strcasecmp(property, "fixedPosition")) {
-				return rule->fixed_position;
-			}
-			if (rule->icon_prefer_client
-					&& !strcasecmp(property, "iconPreferClient")) {
-				return rule->icon_prefer_client;
+		for (int i = 0; i < LAB_RULE_PROP_COUNT; i++) {
+			if (!cache->properties[i]) {
+				cache->properties[i] = (*rule)->properties[i];
 			}
 		}
 	}
-	return LAB_PROP_UNSPECIFIED;
+	wl_array_release(&candidates);
+	cache->generation = generation;
+}
+
+enum property
+window_rules_get_property(struct view *view, enum window_rule_property property)
+{
+	assert(property >= 0 && property < LAB_RULE_PROP_COUNT);
+
+	if (view->rule_cache.generation != generation) {
+		resolve_properties(view);
+	}
+	return view->rule_cache.properties[property];
+}
+
+void
+window_rules_invalidate(struct view *view)
+{
+	view->rule_cache.generation = 0;
+
+	if (!rule_index.valid) {
+		build_index();
+	}
+	/* matchOnce rules depend on all other views */
+	if (rule_index.has_match_once) {
+		bump_generation();
+	}
+}
+
+void
+window_rules_invalidate_all(void)
+{
+	reset_index();
+	bump_generation();
 }
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <assert.h>
+#include <stdlib.h>
 #include <wlr/types/wlr_cursor.h>
 #include <wlr/types/wlr_fractional_scale_v1.h>
 #include <wlr/types/wlr_scene.h>
@@ -11,12 +12,15 @@
 #include "buffer.h"
 #include "common/array.h"
 #include "common/box.h"
+#include "common/buf.h"
 #include "common/macros.h"
 #include "common/mem.h"
+#include "common/time-helpers.h"
 #include "config/rcxml.h"
 #include "decorations.h"
 #include "foreign-toplevel/foreign.h"
 #include "labwc.h"
+#include "layout-transaction.h"
 #include "menu/menu.h"
 #include "node.h"
 #include "output.h"
@@ -27,7 +31,11 @@
 #include "workspaces.h"
 
 #define LAB_XDG_SHELL_VERSION 6
+/* Used until the configure latency of a client is known */
 #define CONFIGURE_TIMEOUT_MS 100
+#define CONFIGURE_TIMEOUT_MIN_MS 30
+#define CONFIGURE_TIMEOUT_MAX_MS 500
+#define CONFIGURE_STATS_NR_CLIENTS 10
 
 static struct xdg_toplevel_view *
 xdg_toplevel_view_from_view(struct view *view)
@@ -70,17 +78,22 @@ xdg_toplevel_view_get_size_hints(struct view *view)
 }
 
 static bool
-xdg_toplevel_view_contains_window_type(struct view *view,
-		enum lab_window_type window_type)
+toplevel_is_dialog(struct wlr_xdg_toplevel *toplevel)
 {
-	assert(view);
-
-	struct wlr_xdg_toplevel *toplevel = xdg_toplevel_from_view(view);
 	struct wlr_xdg_toplevel_state *state = &toplevel->current;
-	bool is_dialog = (state->min_width != 0 && state->min_height != 0
+	return (state->min_width != 0 && state->min_height != 0
 		&& (state->min_width == state->max_width
 		|| state->min_height == state->max_height))
 		|| toplevel->parent;
+}
+
+static bool
+xdg_toplevel_view_contains_window_type(struct view *view,
+		enum lab_window_type window_type)
+{
+	assert(view);
+
+	bool is_dialog = toplevel_is_dialog(xdg_toplevel_from_view(view));
 
 	switch (window_type) {
 	case LAB_WINDOW_TYPE_NORMAL:
@@ -182,6 +195,170 @@ center_fullscreen_if_needed(struct view *view)
 	wlr_scene_node_set_enabled(&xdg_view->fullscreen_bg->node, true);
 }
 
+/*
+ * Clients differ a lot in how fast they respond to configure events. The
+ * configure-to-ack latency of each client is estimated the same way TCP
+ * estimates round-trip times (RFC 6298), and the configure timeout is
+ * derived from it. Slow clients thus get enough time to redraw at the new
+ * size, while windows of fast clients which skip a configure are not held
+ * back longer than needed.
+ */
+struct client_latency {
+	struct wl_client *client;
+	/* app_id of the view last measured */
+	char *app_id;
+	uint32_t nr_samples;
+	uint32_t nr_timeouts;
+	uint64_t smoothed_usec;
+	uint64_t deviation_usec;
+	uint64_t max_usec;
+	struct wl_listener destroy;
+	struct wl_list link; /* client_latencies */
+};
+
+static struct wl_list client_latencies;
+
+static void
+handle_client_destroy(struct wl_listener *listener, void *data)
+{
+	struct client_latency *latency =
+		wl_container_of(listener, latency, destroy);
+	wl_list_remove(&latency->destroy.link);
+	wl_list_remove(&latency->link);
+	free(latency->app_id);
+	free(latency);
+}
+
+static struct client_latency *
+get_client_latency(struct view *view)
+{
+	struct wl_client *client =
+		wl_resource_get_client(xdg_surface_from_view(view)->resource);
+	struct wl_listener *listener =
+		wl_client_get_destroy_listener(client, handle_client_destroy);
+	if (listener) {
+		struct client_latency *latency =
+			wl_container_of(listener, latency, destroy);
+		return latency;
+	}
+
+	struct client_latency *latency = znew(*latency);
+	latency->client = client;
+	latency->destroy.notify = handle_client_destroy;
+	wl_client_add_destroy_listener(client, &latency->destroy);
+	wl_list_insert(&client_latencies, &latency->link);
+	return latency;
+}
+
+static void
+add_latency_sample(struct client_latency *latency, uint64_t usec)
+{
+	if (!latency->nr_samples) {
+		latency->smoothed_usec = usec;
+		latency->deviation_usec = usec / 2;
+	} else {
+		uint64_t delta = usec > latency->smoothed_usec
+			? usec - latency->smoothed_usec
+			: latency->smoothed_usec - usec;
+		latency->deviation_usec = (3 * latency->deviation_usec + delta) / 4;
+		latency->smoothed_usec = (7 * latency->smoothed_usec + usec) / 8;
+	}
+	latency->nr_samples++;
+	latency->max_usec = MAX(latency->max_usec, usec);
+}
+
+static int
+get_configure_timeout(struct client_latency *latency)
+{
+	if (!latency->nr_samples) {
+		return CONFIGURE_TIMEOUT_MS;
+	}
+	uint64_t timeout = (latency->smoothed_usec
+		+ 4 * latency->deviation_usec) / 1000;
+	if (timeout < CONFIGURE_TIMEOUT_MIN_MS) {
+		return CONFIGURE_TIMEOUT_MIN_MS;
+	}
+	if (timeout > CONFIGURE_TIMEOUT_MAX_MS) {
+		return CONFIGURE_TIMEOUT_MAX_MS;
+	}
+	return timeout;
+}
+
+/*
+ * Called on commit with the latest configure serial acked by the client.
+ * The sample is taken even if the configure has timed out already, so
+ * that the estimate grows for slow clients. Samples longer than the
+ * maximum timeout are dropped though: they are usually caused by the
+ * client being stopped or busy with something else, and would inflate
+ * the estimate for a long time.
+ */
+static void
+update_client_latency(struct view *view, uint32_t acked_serial)
+{
+	struct xdg_toplevel_view *xdg_view = xdg_toplevel_view_from_view(view);
+	uint32_t serial = xdg_view->timed_configure_serial;
+
+	/* Acking a configure implicitly acks all earlier ones */
+	if (!serial || (int32_t)(acked_serial - serial) < 0) {
+		return;
+	}
+	xdg_view->timed_configure_serial = 0;
+
+	uint64_t usec =
+		(time_now_nsec() - xdg_view->timed_configure_nsec) / 1000;
+	if (usec > CONFIGURE_TIMEOUT_MAX_MS * 1000) {
+		return;
+	}
+	struct client_latency *latency = get_client_latency(view);
+	add_latency_sample(latency, usec);
+	xstrdup_replace(latency->app_id, view->app_id);
+}
+
+static int
+compare_latencies(const void *a, const void *b)
+{
+	const struct client_latency *la = *(const struct client_latency **)a;
+	const struct client_latency *lb = *(const struct client_latency **)b;
+	return (la->smoothed_usec < lb->smoothed_usec)
+		- (la->smoothed_usec > lb->smoothed_usec);
+}
+
+void
+xdg_shell_print_configure_stats(struct buf *buf)
+{
+	int nr_clients = wl_list_length(&client_latencies);
+	struct client_latency **sorted = znew_n(sorted[0], nr_clients);
+	int nr_sorted = 0;
+
+	struct client_latency *latency;
+	wl_list_for_each(latency, &client_latencies, link) {
+		if (latency->nr_samples) {
+			sorted[nr_sorted++] = latency;
+		}
+	}
+	if (nr_sorted) {
+		qsort(sorted, nr_sorted, sizeof(sorted[0]), compare_latencies);
+	}
+
+	/* Slowest responders first */
+	for (int i = 0; i < MIN(nr_sorted, CONFIGURE_STATS_NR_CLIENTS); i++) {
+		latency = sorted[i];
+		pid_t pid = -1;
+		wl_client_get_credentials(latency->client, &pid, NULL, NULL);
+		buf_add_fmt(buf, "client pid=%d app_id=%s samples=%u "
+			"avg_usec=%llu dev_usec=%llu max_usec=%llu "
+			"timeouts=%u timeout_ms=%d\n",
+			(int)pid, latency->app_id ? latency->app_id : "",
+			latency->nr_samples,
+			(unsigned long long)latency->smoothed_usec,
+			(unsigned long long)latency->deviation_usec,
+			(unsigned long long)latency->max_usec,
+			latency->nr_timeouts, get_configure_timeout(latency));
+	}
+	buf_add(buf, "END\n");
+	free(sorted);
+}
+
 /* TODO: reorder so this forward declaration isn't needed */
 static void set_pending_configure_serial(struct view *view, uint32_t serial);
 
@@ -193,6 +370,14 @@ handle_commit(struct wl_listener *listener, void *data)
 	struct wlr_xdg_toplevel *toplevel = xdg_toplevel_from_view(view);
 	assert(view->surface);
 
+	/* Window rules may match on the window type, which derives from state */
+	struct xdg_toplevel_view *xdg_view = xdg_toplevel_view_from_view(view);
+	bool is_dialog = toplevel_is_dialog(toplevel);
+	if (is_dialog != xdg_view->is_dialog) {
+		xdg_view->is_dialog = is_dialog;
+		window_rules_invalidate(view);
+	}
+
 	if (xdg_surface->initial_commit) {
 		uint32_t serial =
 			wlr_xdg_surface_schedule_configure(xdg_surface);
@@ -279,8 +464,11 @@ handle_commit(struct wl_listener *listener, void *data)
 		update_required = true;
 	}
 
+	update_client_latency(view, xdg_surface->current.configure_serial);
+
 	uint32_t serial = view->pending_configure_serial;
-	if (serial > 0 && serial == xdg_surface->current.configure_serial) {
+	bool acked = serial > 0 && serial == xdg_surface->current.configure_serial;
+	if (acked) {
 		assert(view->pending_configure_timeout);
 		wl_event_source_remove(view->pending_configure_timeout);
 		view->pending_configure_serial = 0;
@@ -329,6 +517,10 @@ handle_commit(struct wl_listener *listener, void *data)
 			toplevel->scheduled.height = view->current.height;
 		}
 	}
+
+	if (acked) {
+		layout_transaction_view_ready(view);
+	}
 }
 
 static int
@@ -338,12 +530,15 @@ handle_configure_timeout(void *data)
 	assert(view->pending_configure_serial > 0);
 	assert(view->pending_configure_timeout);
 
+	struct client_latency *latency = get_client_latency(view);
+	latency->nr_timeouts++;
 	wlr_log(WLR_INFO, "client (%s) did not respond to configure request "
-		"in %d ms", view->app_id, CONFIGURE_TIMEOUT_MS);
+		"in %d ms", view->app_id, get_configure_timeout(latency));
 
 	wl_event_source_remove(view->pending_configure_timeout);
 	view->pending_configure_serial = 0;
 	view->pending_configure_timeout = NULL;
+	layout_transaction_view_ready(view);
 
 	/*
 	 * No need to do anything else if the view is just being slow to
@@ -404,6 +599,16 @@ handle_configure_timeout(void *data)
 static void
 set_pending_configure_serial(struct view *view, uint32_t serial)
 {
+	/*
+	 * Time the oldest unacked configure. The initial configure is
+	 * left out since its latency includes the client start-up.
+	 */
+	struct xdg_toplevel_view *xdg_view = xdg_toplevel_view_from_view(view);
+	if (!xdg_view->timed_configure_serial && view->mapped) {
+		xdg_view->timed_configure_serial = serial;
+		xdg_view->timed_configure_nsec = time_now_nsec();
+	}
+
 	view->pending_configure_serial = serial;
 	if (!view->pending_configure_timeout) {
 		view->pending_configure_timeout =
@@ -411,7 +616,7 @@ set_pending_configure_serial(struct view *view, uint32_t serial)
 				handle_configure_timeout, view);
 	}
 	wl_event_source_timer_update(view->pending_configure_timeout,
-		CONFIGURE_TIMEOUT_MS);
+		get_configure_timeout(get_client_latency(view)));
 }
 
 static void
@@ -597,6 +802,7 @@ xdg_toplevel_view_configure(struct view *view, struct wlr_box geo)
 	view->pending = geo;
 	if (serial > 0) {
 		set_pending_configure_serial(view, serial);
+		layout_transaction_add_view(view);
 	} else if (view->pending_configure_serial == 0) {
 		view->current.x = geo.x;
 		view->current.y = geo.y;
@@ -875,6 +1081,8 @@ handle_unmap(struct wl_listener *listener, void *data)
 		view->mapped = false;
 		view_impl_unmap(view);
 	}
+	/* The ack time of a configure sent before unmap is meaningless */
+	xdg_toplevel_view_from_view(view)->timed_configure_serial = 0;
 }
 
 static pid_t
@@ -971,7 +1179,8 @@ handle_xdg_activation_request(struct wl_listener *listener, void *data)
 	 * }
 	 */
 
-	if (window_rules_get_property(view, "ignoreFocusRequest") == LAB_PROP_TRUE) {
+	if (window_rules_get_property(view, LAB_RULE_PROP_IGNORE_FOCUS_REQUEST)
+			== LAB_PROP_TRUE) {
 		wlr_log(WLR_INFO, "Ignoring focus request due to window rule configuration");
 		return;
 	}
@@ -1085,6 +1294,8 @@ handle_new_xdg_toplevel(struct wl_listener *listener, void *data)
 
 	wl_list_insert(&server->views, &view->link);
 	view->creation_id = server->next_view_creation_id++;
+	/* creation_id is increasing, so appending keeps the list ordered */
+	wl_list_append(&server->views_by_age, &view->age_link);
 }
 
 static void
@@ -1127,6 +1338,8 @@ xdg_shell_init(struct server *server)
 		exit(EXIT_FAILURE);
 	}
 
+	wl_list_init(&client_latencies);
+
 	server->new_xdg_toplevel.notify = handle_new_xdg_toplevel;
 	wl_signal_add(&server->xdg_shell->events.new_toplevel, &server->new_xdg_toplevel);
 
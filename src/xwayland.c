@@ -3,6 +3,7 @@
 #include "xwayland.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_scene.h>
@@ -11,14 +12,18 @@
 #include <wlr/xwayland.h>
 #include "buffer.h"
 #include "common/array.h"
+#include "common/buf.h"
 #include "common/macros.h"
 #include "common/mem.h"
+#include "common/premultiply.h"
 #include "config/rcxml.h"
 #include "config/session.h"
 #include "foreign-toplevel/foreign.h"
 #include "labwc.h"
+#include "layout-transaction.h"
 #include "node.h"
 #include "output.h"
+#include "scaled-buffer/scaled-icon-buffer.h"
 #include "view.h"
 #include "view-impl-common.h"
 #include "window-rules.h"
@@ -26,12 +31,16 @@
 
 enum atoms {
 	ATOM_NET_WM_ICON = 0,
+	ATOM_NET_SUPPORTING_WM_CHECK,
+	ATOM_LABWC_ICON_SYNC,
 
 	ATOM_COUNT,
 };
 
 static const char * const atom_names[] = {
 	[ATOM_NET_WM_ICON] = "_NET_WM_ICON",
+	[ATOM_NET_SUPPORTING_WM_CHECK] = "_NET_SUPPORTING_WM_CHECK",
+	[ATOM_LABWC_ICON_SYNC] = "_LABWC_ICON_SYNC",
 };
 
 static_assert(ARRAY_SIZE(atom_names) == ATOM_COUNT, "atom names out of sync");
@@ -41,6 +50,8 @@ static xcb_atom_t atoms[ATOM_COUNT] = {0};
 static void set_surface(struct view *view, struct wlr_surface *surface);
 static void handle_map(struct wl_listener *listener, void *data);
 static void handle_unmap(struct wl_listener *listener, void *data);
+static void discard_icon_request(struct xwayland_view *xwayland_view);
+static void send_configure(struct xwayland_view *xwayland_view);
 
 static struct xwayland_view *
 xwayland_view_from_view(struct view *view)
@@ -190,6 +201,7 @@ xwayland_view_has_strut_partial(struct view *view)
 static void
 xwayland_view_offer_focus(struct view *view)
 {
+	send_configure(xwayland_view_from_view(view));
 	wlr_xwayland_surface_offer_focus(xwayland_surface_from_view(view));
 }
 
@@ -243,7 +255,7 @@ want_deco(struct wlr_xwayland_surface *xwayland_surface)
 	struct view *view = (struct view *)xwayland_surface->data;
 
 	/* Window-rules take priority if they exist for this view */
-	switch (window_rules_get_property(view, "serverDecoration")) {
+	switch (window_rules_get_property(view, LAB_RULE_PROP_SERVER_DECORATION)) {
 	case LAB_PROP_TRUE:
 		return true;
 	case LAB_PROP_FALSE:
@@ -275,6 +287,7 @@ handle_commit(struct wl_listener *listener, void *data)
 	if (current->width != state->width || current->height != state->height) {
 		view_impl_apply_geometry(view, state->width, state->height);
 		view_moved(view);
+		layout_transaction_view_ready(view);
 	}
 }
 
@@ -342,6 +355,7 @@ handle_destroy(struct wl_listener *listener, void *data)
 	assert(xwayland_view->xwayland_surface->data == view);
 
 	set_surface(view, NULL);
+	discard_icon_request(xwayland_view);
 
 	/*
 	 * Break view <-> xsurface association.  Note that the xsurface
@@ -368,12 +382,89 @@ handle_destroy(struct wl_listener *listener, void *data)
 	view_destroy(view);
 }
 
+/*
+ * XWM requests are collected and sent once per event loop iteration, so
+ * that moving many windows at once (workspace switch, output hotplug,
+ * batched IPC actions) results in one burst of requests rather than a
+ * write per window, and a window configured several times in a row only
+ * receives the last geometry.
+ */
+static struct {
+	struct wl_event_source *idle;
+	bool workarea_pending;
+
+	/* Statistics, see xwayland_print_stats() */
+	uint64_t nr_flushes;
+	uint64_t nr_requests;
+	uint64_t nr_coalesced;
+	uint32_t nr_unflushed;
+	uint32_t max_per_flush;
+} batch;
+
+/* Last _NET_WORKAREA sent, invalid while xwm_workarea_sent is false */
+static struct wlr_box xwm_workarea;
+static bool xwm_workarea_sent;
+
+static int
+handle_batch_idle(void *data)
+{
+	struct server *server = data;
+	batch.idle = NULL;
+	xwayland_flush(server);
+	return 0;
+}
+
+static void
+schedule_batch(struct server *server)
+{
+	if (!batch.idle) {
+		batch.idle = wl_event_loop_add_idle(server->wl_event_loop,
+			handle_batch_idle, server);
+	}
+}
+
+/*
+ * Sends the pending configure of a view, if any. Must also be called
+ * before any other request for the same window (activation, state
+ * changes, close), so that the X server and the client see them after
+ * the geometry they were made for.
+ */
+static void
+send_configure(struct xwayland_view *xwayland_view)
+{
+	if (!xwayland_view->configure_pending) {
+		return;
+	}
+	xwayland_view->configure_pending = false;
+	if (!xwayland_view->xwayland_surface) {
+		return;
+	}
+
+	struct wlr_box *geo = &xwayland_view->configure_geo;
+	wlr_xwayland_surface_configure(xwayland_view->xwayland_surface,
+		geo->x, geo->y, geo->width, geo->height);
+	batch.nr_requests++;
+	batch.nr_unflushed++;
+}
+
 static void
 xwayland_view_configure(struct view *view, struct wlr_box geo)
 {
+	struct xwayland_view *xwayland_view = xwayland_view_from_view(view);
+
 	view->pending = geo;
-	wlr_xwayland_surface_configure(xwayland_surface_from_view(view),
-		geo.x, geo.y, geo.width, geo.height);
+	if (xwayland_view->configure_pending) {
+		batch.nr_coalesced++;
+	}
+	xwayland_view->configure_geo = geo;
+	xwayland_view->configure_pending = true;
+	schedule_batch(view->server);
+
+	/* X11 has no configure acks, so wait for the size to change */
+	if (view->current.width != geo.width
+			|| view->current.height != geo.height) {
+		layout_transaction_add_view(view);
+	}
 
 	/*
 	 * For unknown reasons, XWayland surfaces that are completely
@@ -403,7 +494,7 @@ handle_request_configure(struct wl_listener *listener, void *data)
 	struct view *view = &xwayland_view->base;
 	struct wlr_xwayland_surface_configure_event *event = data;
 	bool ignore_configure_requests = window_rules_get_property(
-		view, "ignoreConfigureRequest") == LAB_PROP_TRUE;
+		view, LAB_RULE_PROP_IGNORE_CONFIGURE_REQUEST) == LAB_PROP_TRUE;
 
 	if (view_is_floating(view) && !ignore_configure_requests) {
 		/* Honor client configure requests for floating views */
@@ -429,7 +520,8 @@ handle_request_activate(struct wl_listener *listener, void *data)
 		wl_container_of(listener, xwayland_view, request_activate);
 	struct view *view = &xwayland_view->base;
 
-	if (window_rules_get_property(view, "ignoreFocusRequest") == LAB_PROP_TRUE) {
+	if (window_rules_get_property(view, LAB_RULE_PROP_IGNORE_FOCUS_REQUEST)
+			== LAB_PROP_TRUE) {
 		wlr_log(WLR_INFO, "Ignoring focus request due to window rule configuration");
 		return;
 	}
@@ -514,6 +606,7 @@ handle_set_class(struct wl_listener *listener, void *data)
 static void
 xwayland_view_close(struct view *view)
 {
+	send_configure(xwayland_view_from_view(view));
 	wlr_xwayland_surface_close(xwayland_surface_from_view(view));
 }
 
@@ -534,7 +627,11 @@ handle_set_decorations(struct wl_listener *listener, void *data)
 static void
 handle_set_window_type(struct wl_listener *listener, void *data)
 {
-	/* Intentionally left blank */
+	struct xwayland_view *xwayland_view =
+		wl_container_of(listener, xwayland_view, set_window_type);
+
+	/* Window rules may match on the window type */
+	window_rules_invalidate(&xwayland_view->base);
 }
 
 static void
@@ -567,61 +664,188 @@ handle_set_strut_partial(struct wl_listener *listener, void *data)
 	}
 }
 
-static void
-update_icon(struct xwayland_view *xwayland_view)
-{
-	if (!xwayland_view->xwayland_surface) {
-		return;
-	}
+/* Window icon sizes in pixels, see xwayland_update_icon_sizes() */
+static struct wl_array icon_sizes;
 
-	xcb_window_t window_id = xwayland_view->xwayland_surface->window_id;
+/* Window on which _LABWC_ICON_SYNC is changed, see request_icon() */
+static xcb_window_t icon_sync_window;
 
-	xcb_connection_t *xcb_conn = wlr_xwayland_get_xwm_connection(
-		xwayland_view->base.server->xwayland);
-	xcb_get_property_cookie_t cookie = xcb_get_property(xcb_conn, 0,
-		window_id, atoms[ATOM_NET_WM_ICON], XCB_ATOM_CARDINAL, 0, 0x10000);
-	xcb_get_property_reply_t *reply = xcb_get_property_reply(xcb_conn, cookie, NULL);
-	if (!reply) {
-		return;
-	}
+static void
+set_icon_from_reply(struct xwayland_view *xwayland_view,
+		xcb_get_property_reply_t *reply)
+{
 	xcb_ewmh_get_wm_icon_reply_t icon;
 	if (!xcb_ewmh_get_wm_icon_from_reply(&icon, reply)) {
 		wlr_log(WLR_INFO, "Invalid x11 icon");
 		view_set_icon(&xwayland_view->base, NULL, NULL);
-		goto out;
+		return;
 	}
 
+	/*
+	 * Clients often supply sizes up to 256px or more. Only decode the
+	 * images which are drawn at one of the current window icon sizes.
+	 */
+	struct wl_array widths;
+	wl_array_init(&widths);
 	xcb_ewmh_wm_icon_iterator_t iter = xcb_ewmh_get_wm_icon_iterator(&icon);
+	for (; iter.rem; xcb_ewmh_get_wm_icon_next(&iter)) {
+		int width = iter.width;
+		array_add(&widths, width);
+	}
+	int nr_widths = widths.size / sizeof(int);
+	bool *used = znew_n(bool, nr_widths);
+	int *size;
+	wl_array_for_each(size, &icon_sizes) {
+		int i = scaled_icon_buffer_choose_client_icon(widths.data,
+			nr_widths, *size);
+		if (i >= 0) {
+			used[i] = true;
+		}
+	}
+	wl_array_release(&widths);
+
 	struct wl_array buffers;
 	wl_array_init(&buffers);
-	for (; iter.rem; xcb_ewmh_get_wm_icon_next(&iter)) {
-		size_t stride = iter.width * 4;
-		uint32_t *buf = xzalloc(iter.height * stride);
-
-		/* Pre-multiply alpha */
-		for (uint32_t y = 0; y < iter.height; y++) {
-			for (uint32_t x = 0; x < iter.width; x++) {
-				uint32_t i = x + y * iter.width;
-				uint8_t *src_pixel = (uint8_t *)&iter.data[i];
-				uint8_t *dst_pixel = (uint8_t *)&buf[i];
-				dst_pixel[0] = src_pixel[0] * src_pixel[3] / 255;
-				dst_pixel[1] = src_pixel[1] * src_pixel[3] / 255;
-				dst_pixel[2] = src_pixel[2] * src_pixel[3] / 255;
-				dst_pixel[3] = src_pixel[3];
-			}
+	iter = xcb_ewmh_get_wm_icon_iterator(&icon);
+	for (int i = 0; iter.rem; xcb_ewmh_get_wm_icon_next(&iter), i++) {
+		if (!used[i]) {
+			continue;
 		}
+		size_t stride = iter.width * 4;
+		uint32_t *buf = xmalloc(iter.height * stride);
+		premultiply_argb32(buf, iter.data, (size_t)iter.width * iter.height);
 
 		struct lab_data_buffer *buffer = buffer_create_from_data(
 			buf, iter.width, iter.height, stride);
 		array_add(&buffers, buffer);
 	}
+	free(used);
 
 	/* view takes ownership of the buffers */
 	view_set_icon(&xwayland_view->base, NULL, &buffers);
 	wl_array_release(&buffers);
+}
 
-out:
+static void
+discard_icon_request(struct xwayland_view *xwayland_view)
+{
+	if (!xwayland_view->icon_request_pending) {
+		return;
+	}
+	xcb_connection_t *xcb_conn = wlr_xwayland_get_xwm_connection(
+		xwayland_view->base.server->xwayland);
+	if (xcb_conn) {
+		xcb_discard_reply(xcb_conn, xwayland_view->icon_request);
+	}
+	xwayland_view->icon_request_pending = false;
+}
+
+/*
+ * Returns the window created by the XWM for _NET_SUPPORTING_WM_CHECK and
+ * selects property changes on it, or XCB_WINDOW_NONE if it is not set.
+ * No client other than the XWM has a reason to listen to changes of its
+ * properties, unlike those of the root window.
+ */
+static xcb_window_t
+get_icon_sync_window(xcb_connection_t *xcb_conn)
+{
+	if (icon_sync_window != XCB_WINDOW_NONE) {
+		return icon_sync_window;
+	}
+
+	/* A single round-trip per X server */
+	xcb_window_t root =
+		xcb_setup_roots_iterator(xcb_get_setup(xcb_conn)).data->root;
+	xcb_get_property_cookie_t cookie = xcb_get_property(xcb_conn, 0,
+		root, atoms[ATOM_NET_SUPPORTING_WM_CHECK], XCB_ATOM_WINDOW, 0, 1);
+	xcb_get_property_reply_t *reply =
+		xcb_get_property_reply(xcb_conn, cookie, NULL);
+	if (reply && xcb_get_property_value_length(reply)
+			== sizeof(xcb_window_t)) {
+		icon_sync_window = *(xcb_window_t *)xcb_get_property_value(reply);
+		uint32_t event_mask = XCB_EVENT_MASK_PROPERTY_CHANGE;
+		xcb_change_window_attributes(xcb_conn, icon_sync_window,
+			XCB_CW_EVENT_MASK, &event_mask);
+	}
 	free(reply);
+	return icon_sync_window;
+}
+
+/*
+ * _NET_WM_ICON can be up to 256KiB, and waiting for the reply would block
+ * the compositor for as long as Xwayland takes to send it. So the reply
+ * is collected later: the request is followed by an empty change of a
+ * property on a window only the XWM listens to. The resulting
+ * PropertyNotify arrives through the XWM event path after the reply, see
+ * handle_x11_event().
+ */
+static void
+request_icon(struct xwayland_view *xwayland_view)
+{
+	if (!xwayland_view->xwayland_surface) {
+		return;
+	}
+
+	xcb_window_t window_id = xwayland_view->xwayland_surface->window_id;
+
+	xcb_connection_t *xcb_conn = wlr_xwayland_get_xwm_connection(
+		xwayland_view->base.server->xwayland);
+
+	/* Only the most recent icon is of interest */
+	discard_icon_request(xwayland_view);
+
+	xcb_window_t sync_window = get_icon_sync_window(xcb_conn);
+	xcb_get_property_cookie_t cookie = xcb_get_property(xcb_conn, 0,
+		window_id, atoms[ATOM_NET_WM_ICON], XCB_ATOM_CARDINAL, 0, 0x10000);
+
+	if (sync_window == XCB_WINDOW_NONE) {
+		/* Should not happen, but better block than lose the icon */
+		xcb_get_property_reply_t *reply =
+			xcb_get_property_reply(xcb_conn, cookie, NULL);
+		if (reply) {
+			set_icon_from_reply(xwayland_view, reply);
+		}
+		free(reply);
+		return;
+	}
+
+	xwayland_view->icon_request = cookie.sequence;
+	xwayland_view->icon_request_pending = true;
+	xcb_change_property(xcb_conn, XCB_PROP_MODE_REPLACE, sync_window,
+		atoms[ATOM_LABWC_ICON_SYNC], XCB_ATOM_CARDINAL, 32, 0, NULL);
+	xcb_flush(xcb_conn);
+}
+
+/* Handle the replies to all icon requests which have arrived */
+static void
+handle_icon_replies(struct server *server)
+{
+	xcb_connection_t *xcb_conn =
+		wlr_xwayland_get_xwm_connection(server->xwayland);
+
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (view->type != LAB_XWAYLAND_VIEW) {
+			continue;
+		}
+		struct xwayland_view *xwayland_view = xwayland_view_from_view(view);
+		if (!xwayland_view->icon_request_pending) {
+			continue;
+		}
+
+		xcb_get_property_reply_t *reply = NULL;
+		xcb_generic_error_t *err = NULL;
+		if (!xcb_poll_for_reply(xcb_conn, xwayland_view->icon_request,
+				(void **)&reply, &err)) {
+			continue;
+		}
+		xwayland_view->icon_request_pending = false;
+		if (reply) {
+			set_icon_from_reply(xwayland_view, reply);
+		}
+		free(reply);
+		free(err);
+	}
 }
 
 static void
@@ -710,6 +934,9 @@ handle_map_request(struct wl_listener *listener, void *data)
 	 * really necessary until the view is actually mapped (and at
 	 * that point the output layout is known for sure).
 	 */
+
+	/* The window is mapped right after this, so don't defer */
+	send_configure(xwayland_view);
 }
 
 static void
@@ -873,6 +1100,7 @@ handle_unmap(struct wl_listener *listener, void *data)
 static void
 xwayland_view_maximize(struct view *view, enum view_axis maximized)
 {
+	send_configure(xwayland_view_from_view(view));
 	wlr_xwayland_surface_set_maximized(xwayland_surface_from_view(view),
 		maximized & VIEW_AXIS_HORIZONTAL, maximized & VIEW_AXIS_VERTICAL);
 }
@@ -880,6 +1108,7 @@ xwayland_view_maximize(struct view *view, enum view_axis maximized)
 static void
 xwayland_view_minimize(struct view *view, bool minimized)
 {
+	send_configure(xwayland_view_from_view(view));
 	wlr_xwayland_surface_set_minimized(xwayland_surface_from_view(view),
 		minimized);
 }
@@ -941,6 +1170,7 @@ xwayland_view_set_activated(struct view *view, bool activated)
 	struct wlr_xwayland_surface *xwayland_surface =
 		xwayland_surface_from_view(view);
 
+	send_configure(xwayland_view_from_view(view));
 	if (activated && xwayland_surface->minimized) {
 		wlr_xwayland_surface_set_minimized(xwayland_surface, false);
 	}
@@ -959,6 +1189,7 @@ xwayland_view_set_activated(struct view *view, bool activated)
 static void
 xwayland_view_set_fullscreen(struct view *view, bool fullscreen)
 {
+	send_configure(xwayland_view_from_view(view));
 	wlr_xwayland_surface_set_fullscreen(xwayland_surface_from_view(view),
 		fullscreen);
 }
@@ -1046,6 +1277,8 @@ xwayland_view_create(struct server *server,
 
 	wl_list_insert(&view->server->views, &view->link);
 	view->creation_id = view->server->next_view_creation_id++;
+	/* creation_id is increasing, so appending keeps the list ordered */
+	wl_list_append(&view->server->views_by_age, &view->age_link);
 
 	if (xsurface->surface) {
 		handle_associate(&xwayland_view->associate, NULL);
@@ -1102,12 +1335,17 @@ handle_x11_event(struct wlr_xwayland *wlr_xwayland, xcb_generic_event_t *event)
 			struct xwayland_view *xwayland_view =
 				xwayland_view_from_window_id(server, ev->window);
 			if (xwayland_view) {
-				update_icon(xwayland_view);
+				request_icon(xwayland_view);
 			} else {
 				wlr_log(WLR_DEBUG, "icon property changed for unknown window");
 			}
 			return true;
 		}
+		if (ev->atom == atoms[ATOM_LABWC_ICON_SYNC]
+				&& ev->window == icon_sync_window) {
+			handle_icon_replies(wlr_xwayland->data);
+			return true;
+		}
 		break;
 	}
 	default:
@@ -1169,7 +1407,12 @@ handle_xwm_ready(struct wl_listener *listener, void *data)
 	struct server *server =
 		wl_container_of(listener, server, xwayland_xwm_ready);
 	wlr_xwayland_set_seat(server->xwayland, server->seat.seat);
+
+	/* The X server may have been restarted, so always set the workarea */
+	xwm_workarea_sent = false;
+	icon_sync_window = XCB_WINDOW_NONE;
 	xwayland_update_workarea(server);
+	xwayland_update_icon_sizes(server);
 }
 
 void
@@ -1280,6 +1523,15 @@ xwayland_server_finish(struct server *server)
 	 */
 	server->xwayland = NULL;
 	wlr_xwayland_destroy(xwayland);
+
+	if (batch.idle) {
+		wl_event_source_remove(batch.idle);
+		batch.idle = NULL;
+	}
+	batch.workarea_pending = false;
+
+	wl_array_release(&icon_sizes);
+	wl_array_init(&icon_sizes);
 }
 
 static bool
@@ -1370,17 +1622,9 @@ xwayland_adjust_usable_area(struct view *view, struct wlr_output_layout *layout,
 	usable->height = usable_bottom - usable->y;
 }
 
-void
-xwayland_update_workarea(struct server *server)
+static void
+send_workarea(struct server *server)
 {
-	/*
-	 * Do nothing if called during destroy or before xwayland is ready.
-	 * This function will be called again from the ready signal handler.
-	 */
-	if (!server->xwayland || !server->xwayland->xwm) {
-		return;
-	}
-
 	struct wlr_box lb;
 	wlr_output_layout_get_box(server->output_layout, NULL, &lb);
 
@@ -1446,7 +1690,62 @@ xwayland_update_workarea(struct server *server)
 		.width = workarea_right - workarea_left,
 		.height = workarea_bottom - workarea_top,
 	};
+
+	/*
+	 * Every X11 client is notified of the property change and may
+	 * re-layout, so avoid it when e.g. a panel resizes without
+	 * affecting the workarea.
+	 */
+	if (xwm_workarea_sent && wlr_box_equal(&workarea, &xwm_workarea)) {
+		return;
+	}
+	xwm_workarea = workarea;
+	xwm_workarea_sent = true;
+
 	wlr_xwayland_set_workareas(server->xwayland, &workarea, 1);
+	batch.nr_requests++;
+	batch.nr_unflushed++;
+}
+
+void
+xwayland_update_workarea(struct server *server)
+{
+	/*
+	 * Do nothing if called during destroy or before xwayland is ready.
+	 * This function will be called again from the ready signal handler.
+	 */
+	if (!server->xwayland || !server->xwayland->xwm) {
+		return;
+	}
+	batch.workarea_pending = true;
+	schedule_batch(server);
+}
+
+void
+xwayland_update_icon_sizes(struct server *server)
+{
+	struct wl_array sizes;
+	wl_array_init(&sizes);
+	scaled_icon_buffer_get_window_icon_sizes(server, &sizes);
+	if (sizes.size == icon_sizes.size && (!sizes.size
+			|| !memcmp(sizes.data, icon_sizes.data, sizes.size))) {
+		wl_array_release(&sizes);
+		return;
+	}
+	wl_array_release(&icon_sizes);
+	icon_sizes = sizes;
+
+	if (!server->xwayland || !server->xwayland->xwm) {
+		return;
+	}
+
+	/* Icons only contain the sizes needed before, so fetch them again */
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (view->type == LAB_XWAYLAND_VIEW) {
+			request_icon(xwayland_view_from_view(view));
+		}
+	}
 }
 
 void
@@ -1456,5 +1755,31 @@ xwayland_flush(struct server *server)
 		return;
 	}
 
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (view->type == LAB_XWAYLAND_VIEW) {
+			send_configure(xwayland_view_from_view(view));
+		}
+	}
+	if (batch.workarea_pending) {
+		batch.workarea_pending = false;
+		send_workarea(server);
+	}
+
 	xcb_flush(wlr_xwayland_get_xwm_connection(server->xwayland));
+	batch.nr_flushes++;
+	batch.max_per_flush = MAX(batch.max_per_flush, batch.nr_unflushed);
+	batch.nr_unflushed = 0;
+}
+
+void
+xwayland_print_stats(struct server *server, struct buf *buf)
+{
+	buf_add_fmt(buf, "xwm flushes=%llu requests=%llu coalesced=%llu "
+		"max_per_flush=%u\n",
+		(unsigned long long)batch.nr_flushes,
+		(unsigned long long)batch.nr_requests,
+		(unsigned long long)batch.nr_coalesced,
+		batch.max_per_flush);
+	buf_add(buf, "END\n");
 }
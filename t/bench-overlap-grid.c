@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Times overlap_grid_find_best() with synthetic layouts of many windows.
+ * Run with 'meson test --benchmark'; it is not part of the regular tests.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "common/overlap-grid.h"
+
+#define NR_WINDOWS 100
+#define NR_LAYOUTS 20
+#define NR_RUNS 100
+
+/*
+ * The target is 1ms per search on a desktop machine. The limit is much
+ * higher so that only a regression in complexity fails on slow builders.
+ */
+#define LIMIT_MSEC 10.0
+
+static const struct wlr_box bounds = {
+	.x = 0, .y = 30, .width = 1920, .height = 1050,
+};
+
+/* Deterministic pseudo random numbers, to keep results reproducible */
+static uint32_t seed = 2;
+
+static int
+random_int(int max)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) % max;
+}
+
+static void
+random_layout(struct wlr_box *rects, int nr_rects)
+{
+	for (int i = 0; i < nr_rects; i++) {
+		rects[i] = (struct wlr_box){
+			.x = bounds.x - 100 + random_int(bounds.width),
+			.y = bounds.y - 100 + random_int(bounds.height),
+			.width = 50 + random_int(800),
+			.height = 50 + random_int(600),
+		};
+	}
+}
+
+static double
+msec_since(struct timespec *start)
+{
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) * 1e3
+		+ (end.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+	struct wlr_box rects[NR_WINDOWS];
+	double total_msec = 0;
+	double max_msec = 0;
+
+	for (int layout = 0; layout < NR_LAYOUTS; layout++) {
+		random_layout(rects, NR_WINDOWS);
+
+		struct timespec start;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (int i = 0; i < NR_RUNS; i++) {
+			int x, y;
+			overlap_grid_find_best(&bounds, rects, NR_WINDOWS,
+				400 + i, 300 + i, &x, &y);
+		}
+		double msec = msec_since(&start) / NR_RUNS;
+		total_msec += msec;
+		if (msec > max_msec) {
+			max_msec = msec;
+		}
+	}
+
+	printf("overlap_grid_find_best() with %d windows: "
+		"%.3f ms average, %.3f ms worst layout\n", NR_WINDOWS,
+		total_msec / NR_LAYOUTS, max_msec);
+	if (max_msec > LIMIT_MSEC) {
+		fprintf(stderr, "slower than the limit of %.1f ms\n", LIMIT_MSEC);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "common/overlap-grid.h"
+
+#define NR_LAYOUTS 200
+
+static const struct wlr_box bounds = {
+	.x = 0, .y = 30, .width = 1920, .height = 1050,
+};
+
+/* Deterministic pseudo random numbers, to keep results reproducible */
+static uint32_t seed;
+
+static int
+random_int(int max)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) % max;
+}
+
+static void
+random_layout(struct wlr_box *rects, int nr_rects)
+{
+	for (int i = 0; i < nr_rects; i++) {
+		rects[i] = (struct wlr_box){
+			.x = bounds.x - 100 + random_int(bounds.width),
+			.y = bounds.y - 100 + random_int(bounds.height),
+			.width = 50 + random_int(800),
+			.height = 50 + random_int(600),
+		};
+	}
+}
+
+static int64_t
+brute_force_overlap(const struct wlr_box *rects, int nr_rects,
+		int x, int y, int width, int height)
+{
+	int64_t overlap = 0;
+	for (int i = 0; i < nr_rects; i++) {
+		int x1 = x > rects[i].x ? x : rects[i].x;
+		int y1 = y > rects[i].y ? y : rects[i].y;
+		int x2 = x + width < rects[i].x + rects[i].width
+			? x + width : rects[i].x + rects[i].width;
+		int y2 = y + height < rects[i].y + rects[i].height
+			? y + height : rects[i].y + rects[i].height;
+		if (x2 > x1 && y2 > y1) {
+			overlap += (int64_t)(x2 - x1) * (y2 - y1);
+		}
+	}
+	return overlap;
+}
+
+static void
+add_candidates(int *pos, int *nr_pos, int edge, int size, int min, int max)
+{
+	if (edge >= min && edge + size <= max) {
+		pos[(*nr_pos)++] = edge;
+	}
+	if (edge - size >= min && edge <= max) {
+		pos[(*nr_pos)++] = edge - size;
+	}
+}
+
+/*
+ * Returns the smallest overlap of all positions aligned with the edges of
+ * the bounds or of any rectangle, or -1 if the region does not fit.
+ */
+static int64_t
+brute_force_min_overlap(const struct wlr_box *rects, int nr_rects,
+		int width, int height)
+{
+	int max_pos = 4 * nr_rects + 4;
+	int *xs = calloc(max_pos, sizeof(int));
+	int *ys = calloc(max_pos, sizeof(int));
+	int nr_xs = 0;
+	int nr_ys = 0;
+
+	int right = bounds.x + bounds.width;
+	int bottom = bounds.y + bounds.height;
+	add_candidates(xs, &nr_xs, bounds.x, width, bounds.x, right);
+	add_candidates(xs, &nr_xs, right, width, bounds.x, right);
+	add_candidates(ys, &nr_ys, bounds.y, height, bounds.y, bottom);
+	add_candidates(ys, &nr_ys, bottom, height, bounds.y, bottom);
+	for (int i = 0; i < nr_rects; i++) {
+		add_candidates(xs, &nr_xs, rects[i].x, width, bounds.x, right);
+		add_candidates(xs, &nr_xs, rects[i].x + rects[i].width,
+			width, bounds.x, right);
+		add_candidates(ys, &nr_ys, rects[i].y, height, bounds.y, bottom);
+		add_candidates(ys, &nr_ys, rects[i].y + rects[i].height,
+			height, bounds.y, bottom);
+	}
+
+	int64_t min_overlap = -1;
+	for (int i = 0; i < nr_ys; i++) {
+		for (int j = 0; j < nr_xs; j++) {
+			int64_t overlap = brute_force_overlap(rects, nr_rects,
+				xs[j], ys[i], width, height);
+			if (min_overlap < 0 || overlap < min_overlap) {
+				min_overlap = overlap;
+			}
+		}
+	}
+	free(xs);
+	free(ys);
+	return min_overlap;
+}
+
+static void
+test_empty(void **state)
+{
+	int x = -1, y = -1;
+	assert_true(overlap_grid_find_best(&bounds, NULL, 0, 800, 600, &x, &y));
+	assert_int_equal(x, bounds.x);
+	assert_int_equal(y, bounds.y);
+
+	/* Too large to fit */
+	x = y = -1;
+	assert_false(overlap_grid_find_best(&bounds, NULL, 0,
+		bounds.width + 1, 600, &x, &y));
+	assert_int_equal(x, -1);
+	assert_int_equal(y, -1);
+}
+
+static void
+test_simple(void **state)
+{
+	/* Left half is covered, so the region goes right next to it */
+	struct wlr_box rects[] = {
+		{ .x = 0, .y = 30, .width = 960, .height = 1050 },
+	};
+	int x, y;
+	assert_true(overlap_grid_find_best(&bounds, rects, 1, 800, 600, &x, &y));
+	assert_int_equal(x, 960);
+	assert_int_equal(y, bounds.y);
+
+	/* Everything is covered, but the right edge only once */
+	struct wlr_box tiles[] = {
+		{ .x = 0, .y = 30, .width = 1920, .height = 1050 },
+		{ .x = 0, .y = 30, .width = 1600, .height = 800 },
+	};
+	assert_true(overlap_grid_find_best(&bounds, tiles, 2, 320, 280, &x, &y));
+	assert_int_equal(x, 1600);
+	assert_int_equal(y, bounds.y);
+}
+
+static void
+test_random_layouts(void **state)
+{
+	struct wlr_box rects[20];
+	seed = 1;
+	for (int i = 0; i < NR_LAYOUTS; i++) {
+		int nr_rects = 1 + random_int(20);
+		random_layout(rects, nr_rects);
+		int width = 50 + random_int(1000);
+		int height = 50 + random_int(800);
+
+		int x, y;
+		assert_true(overlap_grid_find_best(&bounds, rects, nr_rects,
+			width, height, &x, &y));
+		assert_true(x >= bounds.x && x + width <= bounds.x + bounds.width);
+		assert_true(y >= bounds.y && y + height <= bounds.y + bounds.height);
+		assert_int_equal(
+			brute_force_overlap(rects, nr_rects, x, y, width, height),
+			brute_force_min_overlap(rects, nr_rects, width, height));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_empty),
+		cmocka_unit_test(test_simple),
+		cmocka_unit_test(test_random_layouts),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
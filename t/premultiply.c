@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "common/premultiply.h"
+
+static uint32_t
+reference(uint32_t pixel)
+{
+	uint32_t a = pixel >> 24;
+	uint32_t r = (pixel >> 16) & 0xff;
+	uint32_t g = (pixel >> 8) & 0xff;
+	uint32_t b = pixel & 0xff;
+	return a << 24 | ((r * a + 127) / 255) << 16
+		| ((g * a + 127) / 255) << 8 | ((b * a + 127) / 255);
+}
+
+static void
+test_all_values(void **state)
+{
+	/* Every combination of alpha and channel value, in all channels */
+	static uint32_t src[256 * 256];
+	static uint32_t dst[256 * 256];
+	for (uint32_t a = 0; a < 256; a++) {
+		for (uint32_t c = 0; c < 256; c++) {
+			src[a * 256 + c] = a << 24 | c << 16
+				| (255 - c) << 8 | ((c * 7) & 0xff);
+		}
+	}
+	premultiply_argb32(dst, src, 256 * 256);
+	for (size_t i = 0; i < 256 * 256; i++) {
+		assert_int_equal(dst[i], reference(src[i]));
+	}
+}
+
+static void
+test_sizes(void **state)
+{
+	/* Lengths which are not a multiple of any vector size */
+	uint32_t src[37];
+	for (size_t i = 0; i < 37; i++) {
+		src[i] = 0x80000000 | (uint32_t)(i * 0x010203);
+	}
+	for (size_t len = 0; len <= 37; len++) {
+		uint32_t dst[38] = {0};
+		premultiply_argb32(dst, src, len);
+		for (size_t i = 0; i < len; i++) {
+			assert_int_equal(dst[i], reference(src[i]));
+		}
+		assert_int_equal(dst[len], 0);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_all_values),
+		cmocka_unit_test(test_sizes),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}